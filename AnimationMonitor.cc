@@ -0,0 +1,217 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "AnimationMonitor.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QPointer>
+
+// Constants
+namespace {
+// Frame time a workspace may take before its animations are shortened
+static const int kFrameBudget = 40;
+
+// Widgets that may move at once before animations are shortened
+static const int kMovingLimit = 12;
+
+// Weight of the newest frame in the average
+static const qreal kFrameWeight = 0.125;
+
+// Longest frame counted, so a single stall does not disable animations
+static const qint64 kMaxFrameTime = 250;
+
+// Time without frames after which the average is forgotten
+static const qint64 kMeasurementLifetime = 5000;
+
+// Reduced animations take this fraction of their normal duration
+static const int kReducedDivisor = 2;
+}
+
+//=============================================================================
+// struct AnimationMonitor::Policy
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::Policy::Policy()
+//-----------------------------------------------------------------------------
+AnimationMonitor::Policy::Policy()
+    :   mode(PerformanceAuto)
+    ,   frameBudget(kFrameBudget)
+    ,   movingLimit(kMovingLimit)
+{
+}
+
+
+//=============================================================================
+// class AnimationMonitor
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::instance()
+//
+/// Return the monitor shared by the application.
+//-----------------------------------------------------------------------------
+AnimationMonitor*
+AnimationMonitor::instance()
+{
+    // Made again for a new application object
+    static QPointer<AnimationMonitor> sInstance;
+    if (sInstance.isNull())
+        sInstance = new AnimationMonitor();
+
+    return sInstance;
+}
+
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::AnimationMonitor()
+//-----------------------------------------------------------------------------
+AnimationMonitor::AnimationMonitor()
+    :   QObject(QCoreApplication::instance())
+    ,   mPerformanceMode(PerformanceAuto)
+    ,   mAverageFrameTime(0)
+{
+}
+
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::setPerformanceMode()
+//
+/// Set the performance mode of the whole application. Any mode but
+/// PerformanceAuto overrides the policies of every workspace.
+/// \param inMode The mode.
+//-----------------------------------------------------------------------------
+void
+AnimationMonitor::setPerformanceMode(PerformanceMode inMode)
+{
+    if (inMode == mPerformanceMode)
+        return;
+
+    mPerformanceMode = inMode;
+    Q_EMIT performanceModeChanged(inMode);
+}
+
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::reportFrame()
+//
+/// Record the time between two consecutive frames of an animation.
+/// \param inFrameTime The time in msecs.
+//-----------------------------------------------------------------------------
+void
+AnimationMonitor::reportFrame(qint64 inFrameTime)
+{
+    const qreal frameTime = qBound(qint64(0), inFrameTime, kMaxFrameTime);
+
+    if (!mLastReport.isValid() || mLastReport.elapsed() > kMeasurementLifetime)
+        mAverageFrameTime = frameTime;
+    else
+        mAverageFrameTime += (frameTime - mAverageFrameTime) * kFrameWeight;
+
+    mLastReport.start();
+}
+
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::getAverageFrameTime()
+//
+/// \result The recent average frame time in msecs, or 0 if nothing has
+/// animated lately.
+//-----------------------------------------------------------------------------
+qreal
+AnimationMonitor::getAverageFrameTime() const
+{
+    if (!mLastReport.isValid() || mLastReport.elapsed() > kMeasurementLifetime)
+        return 0;
+
+    return mAverageFrameTime;
+}
+
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::getLevel()
+//
+/// Decide how an animation should run now.
+/// \param inPolicy The policy of the animating workspace.
+/// \param inMovingCount The number of widgets that would be moving.
+/// \result The level to animate at.
+//-----------------------------------------------------------------------------
+AnimationMonitor::Level
+AnimationMonitor::getLevel(const Policy& inPolicy, int inMovingCount) const
+{
+    const PerformanceMode theMode = 
+        mPerformanceMode != PerformanceAuto ? mPerformanceMode : inPolicy.mode;
+
+    switch (theMode) {
+        case PerformanceFull:
+            return LevelFull;
+
+        case PerformanceReduced:
+            return LevelReduced;
+
+        case PerformanceOff:
+            return LevelOff;
+
+        case PerformanceAuto:
+            break;
+    }
+
+    const qreal frameTime = getAverageFrameTime();
+    const int movingLimit = inPolicy.movingLimit;
+
+    if (frameTime > 2 * inPolicy.frameBudget
+        || (movingLimit > 0 && inMovingCount > 2 * movingLimit))
+        return LevelOff;
+
+    if (frameTime > inPolicy.frameBudget
+        || (movingLimit > 0 && inMovingCount > movingLimit))
+        return LevelReduced;
+
+    return LevelFull;
+}
+
+
+//-----------------------------------------------------------------------------
+// AnimationMonitor::getDuration()
+//
+/// \param inDuration The normal duration of an animation in msecs.
+/// \param inPolicy The policy of the animating workspace.
+/// \param inMovingCount The number of widgets that would be moving.
+/// \result The duration to animate for, 0 to skip the animation.
+/// \sa getLevel
+//-----------------------------------------------------------------------------
+int
+AnimationMonitor::getDuration(int inDuration, const Policy& inPolicy, int inMovingCount) const
+{
+    switch (getLevel(inPolicy, inMovingCount)) {
+        case LevelFull:
+            return inDuration;
+
+        case LevelReduced:
+            return inDuration / kReducedDivisor;
+
+        case LevelOff:
+            break;
+    }
+
+    return 0;
+}
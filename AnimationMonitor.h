@@ -0,0 +1,92 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef ANIMATION_MONITOR_HAS_BEEN_INCLUDED
+#define ANIMATION_MONITOR_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+
+//=============================================================================
+// class AnimationMonitor
+//=============================================================================
+/// \brief Watches how smoothly the workspace animates, and shortens or
+/// skips its animations when the display cannot keep up.
+///
+/// The layout animations report the time between two of their frames.
+/// When the average goes over a policy's frame budget, or too many
+/// widgets move at once, animations are shortened, and past twice the
+/// budget they are skipped. Measurements are forgotten after a few quiet
+/// seconds, so a display that recovers animates fully again.
+///
+class AnimationMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum PerformanceMode {
+        PerformanceAuto,        ///< Follow the policies and the measurements
+        PerformanceFull,        ///< Always animate fully
+        PerformanceReduced,     ///< Always shorten animations
+        PerformanceOff          ///< Never animate
+    };
+
+    enum Level {
+        LevelFull,
+        LevelReduced,
+        LevelOff
+    };
+
+    /// How the animations of one workspace degrade
+    struct Policy {
+        Policy();
+
+        PerformanceMode mode;   // PerformanceAuto to adapt to the measurements
+        int frameBudget;        // msecs a frame may take before reducing
+        int movingLimit;        // widgets moving at once before reducing, 0 for any
+    };
+
+    static AnimationMonitor* instance();
+
+    void setPerformanceMode(PerformanceMode inMode);
+    PerformanceMode getPerformanceMode() const;
+
+    void reportFrame(qint64 inFrameTime);
+    qreal getAverageFrameTime() const;
+
+    Level getLevel(const Policy& inPolicy, int inMovingCount = 0) const;
+    int getDuration(int inDuration, const Policy& inPolicy, int inMovingCount = 0) const;
+
+Q_SIGNALS:
+    void performanceModeChanged(AnimationMonitor::PerformanceMode inMode);
+
+private:
+    AnimationMonitor();
+    Q_DISABLE_COPY(AnimationMonitor)
+
+    PerformanceMode mPerformanceMode;
+    qreal mAverageFrameTime;
+    QElapsedTimer mLastReport;
+};
+
+inline AnimationMonitor::PerformanceMode AnimationMonitor::getPerformanceMode() const { return mPerformanceMode; }
+
+#endif // !ANIMATION_MONITOR_HAS_BEEN_INCLUDED
@@ -27,6 +27,9 @@ THE SOFTWARE.
 #include <QMouseEvent>
 #include <QPropertyAnimation>
 
+// Local
+#include "RenderingProfile.h"
+
 // Constants
 static const int kPrelight = 180;
 static const int kHover = 780;
@@ -63,12 +66,15 @@ DynamicPixmapItem::DynamicPixmapItem(const QPixmap& inPixmap,
 
 //-----------------------------------------------------------------------------
 // DynamicPixmapItem::hoverEnterEvent
+//
+/// Colorize the item while hovered, except in the low bandwidth rendering
+/// profile, where the effect would repaint the whole item twice.
 //-----------------------------------------------------------------------------
 void
 DynamicPixmapItem::hoverEnterEvent(QGraphicsSceneHoverEvent* inEvent)
 {
     Q_UNUSED(inEvent);
-    mEffect->setEnabled(true);
+    mEffect->setEnabled(!RenderingProfile::instance()->isLowBandwidth());
 }
 
 
@@ -140,10 +146,20 @@ DynamicPolygonItem::DynamicPolygonItem(QGraphicsItem* inParent)
 
 //-----------------------------------------------------------------------------
 // DynamicPolygonItem::setFadeColor
+//
+/// Set the fill color. Driven by the prelight animations, whose frame
+/// times are reported to the AnimationMonitor.
 //-----------------------------------------------------------------------------
 void
 DynamicPolygonItem::setFadeColor(const QColor& inColor)
 {
+    if (mAnimationGroup.state() == QAbstractAnimation::Running) {
+        if (mFrameTimer.isValid())
+            AnimationMonitor::instance()->reportFrame(mFrameTimer.restart());
+        else
+            mFrameTimer.start();
+    }
+
     mFadeColor = inColor;
     setBrush(mFadeColor);
 }
@@ -215,6 +231,10 @@ DynamicPolygonItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* inEvent)
 
 //-----------------------------------------------------------------------------
 // DynamicPolygonItem::setPrelight
+//
+/// Fade in or out of the prelight tint. The fade is shortened, and the
+/// throbbing dropped, when the AnimationMonitor reduces animations, and
+/// the tint is set at once when it turns them off.
 //-----------------------------------------------------------------------------
 void
 DynamicPolygonItem::setPrelight(bool inPrelight)
@@ -227,10 +247,19 @@ DynamicPolygonItem::setPrelight(bool inPrelight)
     // Clear out the old animations
     mAnimationGroup.stop();
     mAnimationGroup.clear();
+    mFrameTimer.invalidate();
+
+    const AnimationMonitor* theMonitor = AnimationMonitor::instance();
+    const int prelightDuration = theMonitor->getDuration(kPrelight, mAnimationPolicy);
+    if (prelightDuration == 0) {
+        mFadeColor = mPrelight ? mPrelightColor : mBackgroundColor;
+        setBrush(mFadeColor);
+        return;
+    }
 
     // Set up the prelight animation
     QPropertyAnimation* prelightAnimation = new QPropertyAnimation(this, "fadeColor");
-    prelightAnimation->setDuration(kPrelight);
+    prelightAnimation->setDuration(prelightDuration);
     mAnimationGroup.addAnimation(prelightAnimation);
 
     if (mPrelight) {
@@ -239,7 +268,7 @@ DynamicPolygonItem::setPrelight(bool inPrelight)
         prelightAnimation->setEndValue(mPrelightColor);
 
         // Set up the hover throbber
-        if (mThrob) {
+        if (mThrob && theMonitor->getLevel(mAnimationPolicy) == AnimationMonitor::LevelFull) {
             QPropertyAnimation* hoverAnimation = new QPropertyAnimation(this, "fadeColor");
             hoverAnimation->setEasingCurve(QEasingCurve::InOutQuad);
             hoverAnimation->setDuration(kHover);
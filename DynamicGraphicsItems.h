@@ -22,11 +22,15 @@ THE SOFTWARE.
 #define DYNAMIC_GRAPHICS_ITEMS_H
 
 // Qt
+#include <QElapsedTimer>
 #include <QGraphicsPixmapItem>
 #include <QGraphicsRectItem>
 #include <QGraphicsScene>
 #include <QSequentialAnimationGroup>
 
+// Local
+#include "AnimationMonitor.h"
+
 // Forward declarations
 class QGraphicsColorizeEffect;
 class QPropertyAnimation;
@@ -82,6 +86,8 @@ public:
     void setPrelight(bool inPrelight);
     void stopPrelight();
 
+    void setAnimationPolicy(const AnimationMonitor::Policy& inPolicy);
+
     QPropertyAnimation* getPosAnimation() const;
 
     QColor fadeColor() const;
@@ -108,10 +114,13 @@ private:
     QColor mHoverColor;
     QColor mFadeColor;
     bool mThrob;
+    AnimationMonitor::Policy mAnimationPolicy;
+    QElapsedTimer mFrameTimer;
 };
 
 inline QColor DynamicPolygonItem::fadeColor() const { return mFadeColor; }
 inline QPropertyAnimation* DynamicPolygonItem::getPosAnimation() const { return mPosAnimation; }
+inline void DynamicPolygonItem::setAnimationPolicy(const AnimationMonitor::Policy& inPolicy) { mAnimationPolicy = inPolicy; }
 
 
 //=============================================================================
@@ -265,6 +265,7 @@ DynamicGridLayout::DynamicGridLayout()
     ,   mDeferLayout(false)
 
 {
+    connect(&mWidgetAnimator, SIGNAL(animationStateChanged()), SIGNAL(animationStateChanged()));
 }
 
 
@@ -281,6 +282,7 @@ DynamicGridLayout::DynamicGridLayout(const Insets& inInsets)
     ,   mAnimate(false)
     ,   mDeferLayout(false)
 {
+    connect(&mWidgetAnimator, SIGNAL(animationStateChanged()), SIGNAL(animationStateChanged()));
 }
 
 
@@ -347,6 +349,11 @@ DynamicGridLayout::removeWidget(QWidget* inWidget)
 
     // Remove the info from the item map.
     mItems.remove(inWidget);
+    mPendingGeometry.remove(inWidget);
+
+    // The caller will finish the layout, possibly with new constraints
+    if (mDeferLayout)
+        return;
         
     // Get rid of any empty grid locations
     compressLayout(emptySpace);
@@ -776,19 +783,57 @@ DynamicGridLayout::updateLayout()
 //-----------------------------------------------------------------------------
 // DynamicGridLayout::getLayoutInfo()
 // 
+/// Calculate the layout info for the managed widgets. The minimum size
+/// of each item is taken from getItemMinimumSize().
+/// \sa computeLayoutInfo
+//-----------------------------------------------------------------------------
+DynamicGridLayoutInfo* 
+DynamicGridLayout::getLayoutInfo()
+{
+    GridIterator iter(mItems);
+    while (iter.hasNext()) {
+        iter.next();
+        iter.value()->setMinimumSize(getItemMinimumSize(iter.key()));
+    }
+
+    return computeLayoutInfo(mItems.values());
+}
+
+
+//-----------------------------------------------------------------------------
+// DynamicGridLayout::getItemMinimumSize()
+// 
+/// Get the minimum size the solver gives a managed widget. Override this
+/// to solve with something other than the size hint of the widget, for
+/// instance a size that can also be worked out without the widget.
+/// \param inWidget The managed widget.
+/// \result The minimum size of the item.
+//-----------------------------------------------------------------------------
+QSize
+DynamicGridLayout::getItemMinimumSize(QWidget* inWidget) const
+{
+    return inWidget->sizeHint();
+}
+
+
+//-----------------------------------------------------------------------------
+// DynamicGridLayout::computeLayoutInfo()
+// 
 /// Calculate the layout info. This will require three iterations
-/// over the children in the layout.
+/// over the items in the layout.
 ///     1. Calculate the dimensions of the grid
 ///     2. Determine which cells contain widgets
 ///     3. Distribute the sizes and weights among the columns and rows.
+/// Only the constraints are consulted, so this is safe to call from a
+/// worker thread on constraints that are not owned by a live layout.
+/// \param inItems The constraints of the items to lay out.
+/// \result The new layout info. The caller owns the result.
 //-----------------------------------------------------------------------------
 DynamicGridLayoutInfo* 
-DynamicGridLayout::getLayoutInfo()
+DynamicGridLayout::computeLayoutInfo(const QList<DynamicGridConstraints*>& inItems)
 {
     DynamicGridLayoutInfo* layoutInfo = new DynamicGridLayoutInfo();
-    QWidget* theWidget = NULL;
     DynamicGridConstraints* constraints = NULL;
-    QSize theSize;
 
     int i = 0;
     int k = 0;
@@ -813,12 +858,7 @@ DynamicGridLayout::getLayoutInfo()
     memset(xMax, 0, kMaxGridSize);
     memset(yMax, 0, kMaxGridSize);
 
-    GridConstIterator iter(mItems);    
-    while(iter.hasNext()) {
-    
-        iter.next();       
-        theWidget = iter.key();
-        constraints = iter.value();
+    Q_FOREACH(constraints, inItems) {
 
         curX = constraints->mGridX;
         curY = constraints->mGridY;
@@ -873,11 +913,6 @@ DynamicGridLayout::getLayoutInfo()
         for (i = curY; i < (curY + curHeight); i++)
             xMax[i] = px;
 
-        theSize = theWidget->sizeHint();
-
-        constraints->mMinWidth = theSize.width();
-        constraints->mMinHeight = theSize.height();
-
         // If we find a width and height of zero, this is the last item.
         if (constraints->height() == 0 && constraints->width() == 0)
             curRow = curCol = -1;
@@ -914,12 +949,7 @@ DynamicGridLayout::getLayoutInfo()
     memset(xMax, 0, kMaxGridSize);
     memset(yMax, 0, kMaxGridSize);
 
-    iter.toFront();
-    while(iter.hasNext()) {
-
-        iter.next();       
-        theWidget = iter.key();
-        constraints = iter.value();
+    Q_FOREACH(constraints, inItems) {
 
         curX = constraints->mGridX;
         curY = constraints->mGridY;
@@ -1021,12 +1051,7 @@ DynamicGridLayout::getLayoutInfo()
          i != INT_MAX;
          i = nextSize, nextSize = INT_MAX) {
 
-        GridIterator it3(mItems);       
-        while (it3.hasNext()) {
-
-            it3.next();       
-            theWidget = it3.key();
-            constraints = it3.value();
+        Q_FOREACH(constraints, inItems) {
 
             if (constraints->mTempWidth == i) {
                 // right column
@@ -1251,18 +1276,34 @@ DynamicGridLayout::getMinSize(QWidget* inWidget, DynamicGridLayoutInfo* inInfo)
 {
     Q_UNUSED(inWidget);
 
+    return getMinSize(inInfo, mContainerInsets);
+}
+
+
+//-----------------------------------------------------------------------------
+// DynamicGridLayout::getMinSize()
+//
+/// Calcluate the minimum size based on the results of computeLayoutInfo()
+/// \param inInfo The layout info.
+/// \param inInsets The container insets.
+/// \result The minimum size.
+//-----------------------------------------------------------------------------
+QSize
+DynamicGridLayout::getMinSize(const DynamicGridLayoutInfo* inInfo, 
+                              const Insets& inInsets)
+{
     QSize theSize;
     
     int i;
     int t = 0;
     for(i = 0; i < inInfo->width; i++)
         t += inInfo->mMinWidth[i];
-    theSize.setWidth(t + mContainerInsets.left() + mContainerInsets.right());
+    theSize.setWidth(t + inInsets.left() + inInsets.right());
 
     t = 0;
     for(i = 0; i < inInfo->height; i++)
         t += inInfo->mMinHeight[i];
-    theSize.setHeight(t + mContainerInsets.top() + mContainerInsets.bottom());
+    theSize.setHeight(t + inInsets.top() + inInsets.bottom());
 
     return theSize;
 }
@@ -1295,117 +1336,217 @@ DynamicGridLayout::layoutGrid(QWidget* inParent)
     delete mLayoutInfo;
     mLayoutInfo = info;
 
+    // The keys and values of the map are returned in the same order.
+    const QList<QWidget*> widgets = mItems.keys();
+    QList<QRect> bounds;
+    computeBounds(mLayoutInfo, mItems.values(), mContainerInsets, inParent->size(), bounds);
+
+    applyBounds(widgets, bounds);
+}
+
+
+//-----------------------------------------------------------------------------
+// DynamicGridLayout::applyBounds()
+//
+/// Move the managed widgets to their solved bounds in one layout pass.
+/// The widgets about to move are counted first, so the animator degrades
+/// all of their motions alike.
+/// \param inWidgets The widgets.
+/// \param inBounds The solved bounds of each widget, in the order of
+/// inWidgets.
+//-----------------------------------------------------------------------------
+void 
+DynamicGridLayout::applyBounds(const QList<QWidget*>& inWidgets, const QList<QRect>& inBounds)
+{
+    Q_ASSERT(inWidgets.size() == inBounds.size());
+
+    int movingCount = 0;
+    for (int index = 0; index < inWidgets.size(); index++) {
+        QWidget* theWidget = inWidgets.at(index);
+        const QRect& theBounds = inBounds.at(index);
+        if (theBounds.width() > 0 && theBounds.height() > 0 &&
+            (theWidget->geometry() != theBounds || mWidgetAnimator.animating(theWidget)))
+            ++movingCount;
+    }
+
+    mWidgetAnimator.beginPass(movingCount);
+
+    for (int index = 0; index < inWidgets.size(); index++)
+        applyBounds(inWidgets.at(index), inBounds.at(index));
+
+    mWidgetAnimator.endPass();
+}
+
+
+//-----------------------------------------------------------------------------
+// DynamicGridLayout::applyBounds()
+//
+/// Move a managed widget to its solved bounds. Widgets that end up without
+/// any area are hidden.
+/// \param inWidget The widget.
+/// \param inBounds The solved bounds of the widget.
+//-----------------------------------------------------------------------------
+void 
+DynamicGridLayout::applyBounds(QWidget* inWidget, const QRect& inBounds)
+{
+    // If the widget is too small, resize it so it is not visible.
+    // A motion still running would bring it back when it finishes.
+    if ((inBounds.width() <= 0) || (inBounds.height() <= 0)) {
+        mWidgetAnimator.abort(inWidget);
+        inWidget->setGeometry(0, 0, 0, 0);
+        inWidget->hide();
+    }
+    else {
+        // A proxied widget keeps its old geometry while it moves
+        if (inWidget->geometry() != inBounds || mWidgetAnimator.animating(inWidget)) {
+            // Animate the widget to the new location and size.
+            mWidgetAnimator.animate(inWidget, 
+                                    inBounds,
+                                    mAnimate);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// DynamicGridLayout::computeBounds()
+//
+/// Distribute the space available in a container of the specified size
+/// among the columns and rows of the layout info and calculate the bounds
+/// of each item. No widgets are touched, so this may run on a worker
+/// thread.
+/// \param ioInfo The layout info from computeLayoutInfo(). The column and
+/// row sizes are updated to fill the container.
+/// \param inItems The constraints the layout info was computed from.
+/// \param inInsets The container insets.
+/// \param inSize The container size.
+/// \param outBounds The bounds of each item, in the order of inItems.
+//-----------------------------------------------------------------------------
+void 
+DynamicGridLayout::computeBounds(DynamicGridLayoutInfo* ioInfo,
+                                 const QList<DynamicGridConstraints*>& inItems,
+                                 const Insets& inInsets,
+                                 const QSize& inSize,
+                                 QList<QRect>& outBounds)
+{
+    const QSize minSize = getMinSize(ioInfo, inInsets);
+
     QRect theBounds;
     theBounds.setWidth(minSize.width());
     theBounds.setHeight(minSize.height());
 
-    Insets insets = mContainerInsets;
     int index = 0;
     float weight = 0;
 
     // If the current dimensions of the window don't match the desired
     // dimensions, then adjust the mMinWidth and mMinHeight arrays
     // according to the weights.
-    int diffw = inParent->width() - theBounds.width();
+    int diffw = inSize.width() - theBounds.width();
     if (diffw != 0) {
         weight = 0.0;
-        for (index = 0; index < mLayoutInfo->width; index++)
-            weight += mLayoutInfo->mWeightX[index];
+        for (index = 0; index < ioInfo->width; index++)
+            weight += ioInfo->mWeightX[index];
             
         if (weight > 0.0) {
-            for (index = 0; index < mLayoutInfo->width; index++) {
-                int dx = (int)(( ((float)diffw) * mLayoutInfo->mWeightX[index]) / weight);
-                mLayoutInfo->mMinWidth[index] += dx;
+            for (index = 0; index < ioInfo->width; index++) {
+                int dx = (int)(( ((float)diffw) * ioInfo->mWeightX[index]) / weight);
+                ioInfo->mMinWidth[index] += dx;
                 theBounds.setWidth(theBounds.width() + dx);
                 
-                if (mLayoutInfo->mMinWidth[index] < 0) {
-                    theBounds.setWidth(theBounds.width() - mLayoutInfo->mMinWidth[index]);
-                    mLayoutInfo->mMinWidth[index] = 0;
+                if (ioInfo->mMinWidth[index] < 0) {
+                    theBounds.setWidth(theBounds.width() - ioInfo->mMinWidth[index]);
+                    ioInfo->mMinWidth[index] = 0;
                 }
             }
         }
-        diffw = inParent->width() - theBounds.width();
+        diffw = inSize.width() - theBounds.width();
     }
     else {
         diffw = 0;
     }
 
-    int diffh = inParent->height() - theBounds.height();
+    int diffh = inSize.height() - theBounds.height();
     if (diffh != 0) {
         weight = 0.0;
-        for (index = 0; index < mLayoutInfo->height; index++)
-            weight += mLayoutInfo->mWeightY[index];
+        for (index = 0; index < ioInfo->height; index++)
+            weight += ioInfo->mWeightY[index];
             
         if (weight > 0.0) {
-            for (index = 0; index < mLayoutInfo->height; index++) {
-                int dy = (int)(( ((float)diffh) * mLayoutInfo->mWeightY[index]) / weight);
-                mLayoutInfo->mMinHeight[index] += dy;
+            for (index = 0; index < ioInfo->height; index++) {
+                int dy = (int)(( ((float)diffh) * ioInfo->mWeightY[index]) / weight);
+                ioInfo->mMinHeight[index] += dy;
                 theBounds.setHeight(theBounds.height() + dy);
                 
-                if (mLayoutInfo->mMinHeight[index] < 0) {
-                    theBounds.setHeight(theBounds.height() - mLayoutInfo->mMinHeight[index]);
-                    mLayoutInfo->mMinHeight[index] = 0;
+                if (ioInfo->mMinHeight[index] < 0) {
+                    theBounds.setHeight(theBounds.height() - ioInfo->mMinHeight[index]);
+                    ioInfo->mMinHeight[index] = 0;
                 }
             }
         }
-        diffh = inParent->height() - theBounds.height();
+        diffh = inSize.height() - theBounds.height();
     }
     else {
         diffh = 0;
     }
 
-    // Do the actual layout of the children using the layout information 
+    // Do the actual layout of the items using the layout information 
     // that has been calculated.
-    mLayoutInfo->startx = diffw / 2 + insets.left();
-    mLayoutInfo->starty = diffh / 2 + insets.top();
+    ioInfo->startx = diffw / 2 + inInsets.left();
+    ioInfo->starty = diffh / 2 + inInsets.top();
     
-    // Iterate over the managed children
-    GridIterator it2(mItems);
-
-    while (it2.hasNext()) {
-        it2.next();                   
-        QWidget* theWidget = it2.key();
-        DynamicGridConstraints* constraints = it2.value();
+    outBounds.clear();
+    Q_FOREACH(DynamicGridConstraints* constraints, inItems) {
 
-        theBounds.setX(mLayoutInfo->startx);
+        theBounds.setX(ioInfo->startx);
         for (index = 0; index < constraints->mTempX; index++)
-           theBounds.setX(theBounds.x() + mLayoutInfo->mMinWidth[index]);
+           theBounds.setX(theBounds.x() + ioInfo->mMinWidth[index]);
 
 
-        theBounds.setY(mLayoutInfo->starty);
+        theBounds.setY(ioInfo->starty);
         for(index = 0; index < constraints->mTempY; index++)
-            theBounds.setY(theBounds.y() + mLayoutInfo->mMinHeight[index]);
+            theBounds.setY(theBounds.y() + ioInfo->mMinHeight[index]);
 
         theBounds.setWidth(0);
         for(index = constraints->mTempX; index < (constraints->mTempX + constraints->mTempWidth); index++) {
-            theBounds.setWidth(theBounds.width() + mLayoutInfo->mMinWidth[index]);
+            theBounds.setWidth(theBounds.width() + ioInfo->mMinWidth[index]);
         }
 
 
         theBounds.setHeight(0);
         for(index = constraints->mTempY; index < (constraints->mTempY + constraints->mTempHeight); index++) {
-            theBounds.setHeight(theBounds.height() + mLayoutInfo->mMinHeight[index]);
+            theBounds.setHeight(theBounds.height() + ioInfo->mMinHeight[index]);
         }
 
         adjustForGravity(constraints, theBounds);
 
-        // If the widget is too small, resize it so it is not visible.
-        if ((theBounds.width() <= 0) || (theBounds.height() <= 0)) {
-            theWidget->setGeometry(0, 0, 0, 0);
-            theWidget->hide();
-        }
-        else {
-            if (theWidget->geometry() != theBounds) {
-                // Animate the widget to the new location and size.
-                mWidgetAnimator.animate(theWidget, 
-                                        theBounds,
-                                        mAnimate);
-            }
-        }
+        outBounds.append(theBounds);
     }
 }
 
 
+//-----------------------------------------------------------------------------
+// DynamicGridLayout::solveLayout()
+//
+/// Solve a grid without a parent widget. Each item's minimum size must
+/// already be set on its constraints. The constraints are used as scratch
+/// space by the solver, so they should not belong to a live layout.
+/// \param inItems The constraints of the items to lay out.
+/// \param inInsets The container insets.
+/// \param inSize The container size.
+/// \param outBounds The bounds of each item, in the order of inItems.
+//-----------------------------------------------------------------------------
+void 
+DynamicGridLayout::solveLayout(const QList<DynamicGridConstraints*>& inItems,
+                               const Insets& inInsets,
+                               const QSize& inSize,
+                               QList<QRect>& outBounds)
+{
+    DynamicGridLayoutInfo* info = computeLayoutInfo(inItems);
+    computeBounds(info, inItems, inInsets, inSize, outBounds);
+    delete info;
+}
+
+
 //-----------------------------------------------------------------------------
 // DynamicGridLayout::getGridInfo()
 //-----------------------------------------------------------------------------
@@ -1677,17 +1818,59 @@ DynamicGridLayout::beginDeferLayout()
 //-----------------------------------------------------------------------------
 // DynamicGridLayout::endDeferLayout()
 //
-/// Allow layout. updateLayout() will be called by this method.
+/// Allow layout. updateLayout() will be called by this method, unless
+/// geometry for every item was handed over with setPendingGeometry(). In
+/// that case the geometry was solved ahead of time from the same
+/// constraints, so the widgets are moved straight to it and only the
+/// layout info is rebuilt. The grid is neither solved nor filled again.
 /// \sa updateLayout
+/// \sa setPendingGeometry
 //-----------------------------------------------------------------------------
 void
 DynamicGridLayout::endDeferLayout()
 {
     mDeferLayout = false;
-    
-    updateLayout();
-    
-    fillEmptySpace();
+
+    const QMap<QWidget*, QRect> pendingGeometry = mPendingGeometry;
+    mPendingGeometry.clear();
+
+    bool committed = !pendingGeometry.isEmpty();
+    Q_FOREACH(QWidget* theWidget, mItems.keys()) {
+        if (!pendingGeometry.contains(theWidget)) {
+            committed = false;
+            break;
+        }
+    }
+
+    if (!committed) {
+        updateLayout();
+        fillEmptySpace();
+        return;
+    }
+
+    // The column and row queries read the layout info. The bounds are
+    // only needed to place the grid origin, no widget is moved by this.
+    QWidget* theParent = parentWidget();
+    Q_ASSERT(theParent != NULL);
+
+    delete mLayoutInfo;
+    mLayoutInfo = getLayoutInfo();
+
+    QList<QRect> bounds;
+    computeBounds(mLayoutInfo, mItems.values(), mContainerInsets, theParent->size(), bounds);
+
+    QList<QWidget*> widgets;
+    QList<QRect> geometry;
+    QMapIterator<QWidget*, QRect> iter(pendingGeometry);
+    while (iter.hasNext()) {
+        iter.next();
+        if (mItems.contains(iter.key())) {
+            widgets.append(iter.key());
+            geometry.append(iter.value());
+        }
+    }
+
+    applyBounds(widgets, geometry);
 }
 
 
@@ -128,6 +128,9 @@ public:
     
     const Insets& insets() const;
     void setInsets(const Insets& inInsets);
+
+    QSize minimumSize() const;
+    void setMinimumSize(const QSize& inSize);
     
     QPoint location() const;
     QRect bounds() const;
@@ -175,6 +178,8 @@ inline void DynamicGridConstraints::setWeightY(float inWeight) { mWeightY = inWe
 inline int DynamicGridConstraints::fill() const { return mFill; }
 inline void DynamicGridConstraints::setFill(int inFill) { mFill = inFill; }
 inline QSize DynamicGridConstraints::size() const { return QSize(mGridWidth, mGridHeight); }
+inline QSize DynamicGridConstraints::minimumSize() const { return QSize(mMinWidth, mMinHeight); }
+inline void DynamicGridConstraints::setMinimumSize(const QSize& inSize) { mMinWidth = inSize.width(); mMinHeight = inSize.height(); }
 
 
 
@@ -272,9 +277,24 @@ public:
     void beginDeferLayout();
     void endDeferLayout();
     bool deferLayout() const;
+    void setPendingGeometry(const QMap<QWidget*, QRect>& inGeometry);
+
+    bool isAnimating(QWidget* inWidget) const;
+    WidgetAnimator::Mode animationMode() const;
+    void setAnimationMode(WidgetAnimator::Mode inMode);
+    const AnimationMonitor::Policy& animationPolicy() const;
+    void setAnimationPolicy(const AnimationMonitor::Policy& inPolicy);
     
     void dumpLayout(const QString& inMessage = "");
 
+    static void solveLayout(const QList<DynamicGridConstraints*>& inItems,
+                            const Insets& inInsets,
+                            const QSize& inSize,
+                            QList<QRect>& outBounds);
+
+Q_SIGNALS:
+    void animationStateChanged();
+
 protected:
     QPoint getLayoutOrigin() const;
 
@@ -283,17 +303,28 @@ protected:
 
     void location(int x, int y, QPoint& outPoint);
 
-    void adjustForGravity(DynamicGridConstraints* constraints, QRect& ioRect);
+    static void adjustForGravity(DynamicGridConstraints* constraints, QRect& ioRect);
 
     QSize getMinSize(QWidget* inWidget, DynamicGridLayoutInfo* info);
+    static QSize getMinSize(const DynamicGridLayoutInfo* inInfo, const Insets& inInsets);
 
     void layoutGrid(QWidget* parent);
 
     DynamicGridLayoutInfo* getGridInfo(QWidget* parent);        
     DynamicGridLayoutInfo* getLayoutInfo();
+    virtual QSize getItemMinimumSize(QWidget* inWidget) const;
+
+    static DynamicGridLayoutInfo* computeLayoutInfo(const QList<DynamicGridConstraints*>& inItems);
+    static void computeBounds(DynamicGridLayoutInfo* ioInfo,
+                              const QList<DynamicGridConstraints*>& inItems,
+                              const Insets& inInsets,
+                              const QSize& inSize,
+                              QList<QRect>& outBounds);
 
 private:
     void setConstraints(QWidget* inWidget, const DynamicGridConstraints& inConstraints);
+    void applyBounds(const QList<QWidget*>& inWidgets, const QList<QRect>& inBounds);
+    void applyBounds(QWidget* inWidget, const QRect& inBounds);
     
     DynamicGridConstraints defaultConstraints;
     DynamicGridLayoutInfo* mLayoutInfo;
@@ -310,12 +341,19 @@ private:
     WidgetAnimator mWidgetAnimator;
     bool mAnimate;
     bool mDeferLayout;
+    QMap<QWidget*, QRect> mPendingGeometry;
 };
 
 inline const DynamicGridLayout::ConstraintsMap& DynamicGridLayout::getConstraintsMap() const { return mItems; }
 inline bool DynamicGridLayout::animate() const { return mAnimate; }
 inline void DynamicGridLayout::setAnimate(bool inAnimate) { mAnimate = inAnimate; }
 inline bool DynamicGridLayout::deferLayout() const { return mDeferLayout; }
+inline void DynamicGridLayout::setPendingGeometry(const QMap<QWidget*, QRect>& inGeometry) { mPendingGeometry = inGeometry; }
+inline bool DynamicGridLayout::isAnimating(QWidget* inWidget) const { return mWidgetAnimator.animating(inWidget); }
+inline WidgetAnimator::Mode DynamicGridLayout::animationMode() const { return mWidgetAnimator.getMode(); }
+inline void DynamicGridLayout::setAnimationMode(WidgetAnimator::Mode inMode) { mWidgetAnimator.setMode(inMode); }
+inline const AnimationMonitor::Policy& DynamicGridLayout::animationPolicy() const { return mWidgetAnimator.getPolicy(); }
+inline void DynamicGridLayout::setAnimationPolicy(const AnimationMonitor::Policy& inPolicy) { mWidgetAnimator.setPolicy(inPolicy); }
 
 
 
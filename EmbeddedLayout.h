@@ -0,0 +1,65 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef EMBEDDED_LAYOUT_HAS_BEEN_INCLUDED
+#define EMBEDDED_LAYOUT_HAS_BEEN_INCLUDED
+
+//=============================================================================
+// struct EmbeddedPanelGroup
+//=============================================================================
+/*! A panel group of a layout that is compiled into the binary.
+    This mirrors WorkspaceArea::SavedGroup using only constant data, so a
+    table of groups is initialized statically and needs no parsing or
+    allocation at startup.
+*/
+struct EmbeddedPanelGroup
+{
+    const char* name;
+    int gridx;
+    int gridy;
+    int gridwidth;
+    int gridheight;
+    int x;
+    int y;
+    int width;
+    int height;
+    int active;
+    const char* const* panels;
+    int panelCount;
+};
+
+//=============================================================================
+// struct EmbeddedLayout
+//=============================================================================
+/*! A layout that is compiled into the binary.
+    Tables of this type are generated from layout files at build time by
+    tools/embed_layout.py. Strings are UTF-8.
+    \sa WorkspaceArea::restoreState
+*/
+struct EmbeddedLayout
+{
+    const char* name;
+    const EmbeddedPanelGroup* groups;
+    int groupCount;
+};
+
+
+#endif // !EMBEDDED_LAYOUT_HAS_BEEN_INCLUDED
+
@@ -0,0 +1,172 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "FloatingWindowPool.h"
+
+// Qt
+#include <QVBoxLayout>
+#include <QWidget>
+
+// Number of idle frames kept by default
+static const int kDefaultCapacity = 2;
+
+//=============================================================================
+// class FloatingWindowPool
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::FloatingWindowPool()
+//
+/// \param inParent The widget that owns the frames.
+//-----------------------------------------------------------------------------
+FloatingWindowPool::FloatingWindowPool(QWidget* inParent)
+    :   QObject(inParent)
+    ,   mParent(inParent)
+    ,   mCapacity(kDefaultCapacity)
+{
+    Q_ASSERT(inParent != NULL);
+}
+
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::~FloatingWindowPool()
+//-----------------------------------------------------------------------------
+FloatingWindowPool::~FloatingWindowPool()
+{
+    // The frames are children of the parent widget, which deletes them
+}
+
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::acquire()
+//
+/// Move a widget into a top level frame. The frame is placed where the
+/// widget currently is and sized to it. Neither is shown.
+/// \param inContent The widget to host.
+/// \result The frame now hosting the widget.
+/// \sa release
+//-----------------------------------------------------------------------------
+QWidget*
+FloatingWindowPool::acquire(QWidget* inContent)
+{
+    Q_ASSERT(inContent != NULL);
+
+    QWidget* theFrame = mFrames.isEmpty() ? createFrame() : mFrames.takeLast();
+
+    QRect theGeometry(inContent->mapToGlobal(QPoint(0, 0)), inContent->size());
+    if (inContent->isWindow())
+        theGeometry = inContent->geometry();
+
+    theFrame->setWindowTitle(inContent->windowTitle());
+    theFrame->setGeometry(theGeometry);
+    theFrame->layout()->addWidget(inContent);
+
+    return theFrame;
+}
+
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::release()
+//
+/// Hide a frame and keep it for the next floating panel. Its content must
+/// already have been moved out. Frames beyond the capacity are deleted.
+/// \param inFrame The frame returned by acquire.
+//-----------------------------------------------------------------------------
+void
+FloatingWindowPool::release(QWidget* inFrame)
+{
+    Q_ASSERT(inFrame != NULL);
+    Q_ASSERT(!mFrames.contains(inFrame));
+
+    inFrame->hide();
+
+    if (mFrames.count() >= mCapacity) {
+        inFrame->deleteLater();
+        return;
+    }
+
+    mFrames.append(inFrame);
+}
+
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::setCapacity()
+//
+/// Set how many idle frames are kept. Zero disables pooling, so every
+/// undock creates a new native window.
+/// \param inCapacity The number of frames.
+//-----------------------------------------------------------------------------
+void
+FloatingWindowPool::setCapacity(int inCapacity)
+{
+    mCapacity = qMax(0, inCapacity);
+
+    while (mFrames.count() > mCapacity)
+        mFrames.takeLast()->deleteLater();
+}
+
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::reserve() [slot]
+//
+/// Fill the pool up to its capacity, so that the first undock does not
+/// have to create a native window either.
+//-----------------------------------------------------------------------------
+void
+FloatingWindowPool::reserve()
+{
+    while (mFrames.count() < mCapacity)
+        mFrames.append(createFrame());
+}
+
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::onFrameDestroyed() [slot]
+//-----------------------------------------------------------------------------
+void
+FloatingWindowPool::onFrameDestroyed(QObject* inFrame)
+{
+    mFrames.removeAll(static_cast<QWidget*>(inFrame));
+}
+
+
+//-----------------------------------------------------------------------------
+// FloatingWindowPool::createFrame()
+//
+/// Create a hidden frame along with its native window.
+//-----------------------------------------------------------------------------
+QWidget*
+FloatingWindowPool::createFrame()
+{
+    QWidget* theFrame = new QWidget(mParent, Qt::Window);
+    theFrame->setObjectName("FloatingFrame");
+
+    QVBoxLayout* theLayout = new QVBoxLayout(theFrame);
+    theLayout->setContentsMargins(0, 0, 0, 0);
+    theLayout->setSpacing(0);
+
+    // Creating the window now is the whole point of the pool
+    theFrame->winId();
+
+    connect(theFrame, SIGNAL(destroyed(QObject*)), this, SLOT(onFrameDestroyed(QObject*)));
+
+    return theFrame;
+}
@@ -0,0 +1,77 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef FLOATING_WINDOW_POOL_HAS_BEEN_INCLUDED
+#define FLOATING_WINDOW_POOL_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QList>
+#include <QObject>
+
+// Forward declarations
+class QWidget;
+
+//=============================================================================
+// class FloatingWindowPool
+//=============================================================================
+/// \brief Keeps already created top level frames for floating panels.
+///
+/// Turning a child widget into a window, or back, destroys and recreates
+/// its native window. Instead, a floating panel is reparented into a frame
+/// taken from the pool, and the frame is hidden and returned to the pool
+/// when the panel is docked again. The frames are children of the pool's
+/// widget, so they stay on top of its window.
+///
+class FloatingWindowPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    FloatingWindowPool(QWidget* inParent);
+    ~FloatingWindowPool();
+
+    QWidget* acquire(QWidget* inContent);
+    void release(QWidget* inFrame);
+
+    int capacity() const;
+    void setCapacity(int inCapacity);
+
+    int count() const;
+
+public Q_SLOTS:
+    void reserve();
+
+private Q_SLOTS:
+    void onFrameDestroyed(QObject* inFrame);
+
+private:
+    Q_DISABLE_COPY(FloatingWindowPool)
+
+    QWidget* createFrame();
+
+    QWidget* mParent;
+    QList<QWidget*> mFrames;
+    int mCapacity;
+};
+
+inline int FloatingWindowPool::capacity() const { return mCapacity; }
+inline int FloatingWindowPool::count() const { return mFrames.count(); }
+
+#endif // !FLOATING_WINDOW_POOL_HAS_BEEN_INCLUDED
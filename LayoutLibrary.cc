@@ -0,0 +1,326 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "LayoutLibrary.h"
+
+// Qt
+#include <QBuffer>
+#include <QDataStream>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+// Namespaces
+using namespace workspace;
+
+// Constants
+static const quint32 kLibraryMagic = 0x574b4c42; // "WKLB"
+static const quint32 kLibraryVersion = 1;
+
+// The smallest index entry: an empty name, offset, size and geometry
+static const qint64 kMinIndexEntrySize = 4 + 4 + 4 + 16;
+
+static const char* kLayoutElement = "layout";
+static const char* kNameAttribute = "name";
+
+//=============================================================================
+// class LayoutLibrary
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::LayoutLibrary()
+//-----------------------------------------------------------------------------
+LayoutLibrary::LayoutLibrary()
+    :   mData(NULL),
+        mSize(0)
+{
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::~LayoutLibrary()
+//-----------------------------------------------------------------------------
+LayoutLibrary::~LayoutLibrary()
+{
+    close();
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::open()
+//
+/// Open a layout library and read its index. The file is memory mapped
+/// when possible. Files that can't be mapped, such as built-in resources,
+/// are read into memory instead.
+/// \param inFileName The library file.
+/// \result True if the library was opened.
+//-----------------------------------------------------------------------------
+bool
+LayoutLibrary::open(const QString& inFileName)
+{
+    close();
+
+    mFile.setFileName(inFileName);
+    if (!mFile.open(QIODevice::ReadOnly))
+        return false;
+
+    mSize = mFile.size();
+    mData = mFile.map(0, mSize);
+    if (mData == NULL) {
+        mBuffer = mFile.readAll();
+        mFile.close();
+        mData = reinterpret_cast<const uchar*>(mBuffer.constData());
+        mSize = mBuffer.size();
+    }
+
+    if (!readIndex()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::close()
+//
+/// Unmap the file and clear the index.
+//-----------------------------------------------------------------------------
+void
+LayoutLibrary::close()
+{
+    if (mFile.isOpen()) {
+        if (mData != NULL)
+            mFile.unmap(const_cast<uchar*>(mData));
+        mFile.close();
+    }
+
+    mData = NULL;
+    mSize = 0;
+    mBuffer.clear();
+    mIndex.clear();
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::readIndex()
+//
+/// Read the index from the head of the file. The file may be damaged or
+/// crafted, so the entry count and every entry are checked against the
+/// file size before anything is read through them.
+/// \result True if the index was valid.
+//-----------------------------------------------------------------------------
+bool
+LayoutLibrary::readIndex()
+{
+    const QByteArray theHeader = QByteArray::fromRawData(reinterpret_cast<const char*>(mData), mSize);
+    QDataStream stream(theHeader);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+
+    if (stream.status() != QDataStream::Ok
+        || magic != kLibraryMagic 
+        || version != kLibraryVersion)
+        return false;
+
+    // Each entry takes some bytes, so a count the file can't hold is bogus
+    const qint64 remaining = mSize - stream.device()->pos();
+    if (qint64(count) > remaining / kMinIndexEntrySize)
+        return false;
+
+    for (quint32 index = 0; index < count; ++index) {
+        QString name;
+        quint32 offset = 0;
+        quint32 size = 0;
+        IndexEntry entry;
+        stream >> name >> offset >> size >> entry.geometry;
+        if (stream.status() != QDataStream::Ok)
+            return false;
+
+        entry.offset = offset;
+        entry.size = size;
+        mIndex[name] = entry;
+    }
+
+    // Offsets are relative to the end of the index
+    const qint64 dataStart = stream.device()->pos();
+
+    QMutableMapIterator<QString, IndexEntry> iter(mIndex);
+    while (iter.hasNext()) {
+        iter.next();
+
+        IndexEntry& entry = iter.value();
+        entry.offset += dataStart;
+        if (entry.offset > mSize || entry.size > mSize - entry.offset)
+            return false;
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::getRawLayout()
+//
+/// Get the encoded layout without copying it out of the mapped file.
+/// \param inEntry The index entry of the layout.
+/// \result The encoded layout.
+//-----------------------------------------------------------------------------
+QByteArray
+LayoutLibrary::getRawLayout(const IndexEntry& inEntry) const
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(mData) + inEntry.offset,
+                                   int(inEntry.size));
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::readLayout()
+//
+/// Decode a single layout from the library.
+/// \param inName The name of the layout.
+/// \param outLayout The layout to populate.
+/// \result True if the layout was found and decoded.
+//-----------------------------------------------------------------------------
+bool
+LayoutLibrary::readLayout(const QString& inName, SavedLayout& outLayout) const
+{
+    Index::const_iterator iter = mIndex.find(inName);
+    if (iter == mIndex.end())
+        return false;
+
+    QXmlStreamReader xmlStream(getRawLayout(iter.value()));
+
+    outLayout = SavedLayout(inName);
+    outLayout.geometry = iter.value().geometry;
+
+    return WorkspaceArea::restoreState(xmlStream, outLayout.layout);
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::encodeLayout()
+//
+/// Encode a layout for storage in the library.
+/// \param inName The name of the layout.
+/// \param inLayout The layout to encode.
+/// \result The encoded layout.
+//-----------------------------------------------------------------------------
+QByteArray
+LayoutLibrary::encodeLayout(const QString& inName, const SavedLayout& inLayout)
+{
+    QByteArray theData;
+    QXmlStreamWriter stream(&theData);
+
+    stream.writeStartElement(kLayoutElement);
+    stream.writeAttribute(kNameAttribute, inName);
+    WorkspaceArea::saveState(stream, inLayout.layout.second);
+    stream.writeEndElement(); // kLayoutElement
+
+    return theData;
+}
+
+
+//-----------------------------------------------------------------------------
+// LayoutLibrary::save()
+//
+/// Write a library holding the given layouts and every layout in this
+/// library that has not been decoded. Layouts that were never decoded
+/// are copied as is. The library is reopened from the new file.
+/// \param inFileName The file to write.
+/// \param inLayouts The decoded layouts, which take precedence.
+/// \result True if the library was written.
+//-----------------------------------------------------------------------------
+bool
+LayoutLibrary::save(const QString& inFileName, const QMap<QString, SavedLayout>& inLayouts)
+{
+    Index theIndex;
+    QByteArray theData;
+
+    // Copy the layouts that were never decoded
+    QMapIterator<QString, IndexEntry> indexIter(mIndex);
+    while (indexIter.hasNext()) {
+        indexIter.next();
+
+        if (inLayouts.contains(indexIter.key()))
+            continue;
+
+        const QByteArray theLayout = getRawLayout(indexIter.value());
+
+        IndexEntry entry;
+        entry.offset = theData.size();
+        entry.size = theLayout.size();
+        entry.geometry = indexIter.value().geometry;
+        theIndex[indexIter.key()] = entry;
+
+        theData.append(theLayout);
+    }
+
+    // Encode the rest
+    QMapIterator<QString, SavedLayout> layoutIter(inLayouts);
+    while (layoutIter.hasNext()) {
+        layoutIter.next();
+
+        const QByteArray theLayout = encodeLayout(layoutIter.key(), layoutIter.value());
+
+        IndexEntry entry;
+        entry.offset = theData.size();
+        entry.size = theLayout.size();
+        entry.geometry = layoutIter.value().geometry;
+        theIndex[layoutIter.key()] = entry;
+
+        theData.append(theLayout);
+    }
+
+    // Write the index
+    QByteArray theFile;
+    QDataStream stream(&theFile, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << kLibraryMagic << kLibraryVersion << quint32(theIndex.size());
+
+    QMapIterator<QString, IndexEntry> iter(theIndex);
+    while (iter.hasNext()) {
+        iter.next();
+        stream << iter.key() 
+               << quint32(iter.value().offset) 
+               << quint32(iter.value().size) 
+               << iter.value().geometry;
+    }
+
+    theFile.append(theData);
+
+    // We may be overwriting the mapped file
+    close();
+
+    QFile libraryFile(inFileName);
+    if (!libraryFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    const bool written = libraryFile.write(theFile) == theFile.size();
+    libraryFile.close();
+
+    return written && open(inFileName);
+}
+
@@ -0,0 +1,97 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef LAYOUT_LIBRARY_HAS_BEEN_INCLUDED
+#define LAYOUT_LIBRARY_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QByteArray>
+#include <QFile>
+#include <QMap>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+
+// Local
+#include "Workspace.h"
+
+namespace workspace {
+
+//=============================================================================
+// class LayoutLibrary
+//=============================================================================
+/*! A file holding many named layouts.
+    The file begins with an index of layout names, each with the offset
+    and size of its encoded layout. The file is memory mapped when opened
+    and only the index is read. A layout is decoded the first time it
+    is asked for.
+*/
+class LayoutLibrary
+{
+public:
+    LayoutLibrary();
+    ~LayoutLibrary();
+
+    bool open(const QString& inFileName);
+    void close();
+    bool isOpen() const;
+
+    bool contains(const QString& inName) const;
+    QStringList getLayoutNames() const;
+    bool readLayout(const QString& inName, SavedLayout& outLayout) const;
+    void remove(const QString& inName);
+
+    bool save(const QString& inFileName, const QMap<QString, SavedLayout>& inLayouts);
+
+private:
+    // No copying
+    LayoutLibrary(const LayoutLibrary& c);
+    LayoutLibrary& operator = (const LayoutLibrary& c);
+
+    struct IndexEntry
+    {
+        qint64 offset;
+        qint64 size;
+        QRect geometry;
+    };
+
+    typedef QMap<QString, IndexEntry> Index;
+
+    bool readIndex();
+    QByteArray getRawLayout(const IndexEntry& inEntry) const;
+
+    static QByteArray encodeLayout(const QString& inName, const SavedLayout& inLayout);
+
+    QFile mFile;
+    const uchar* mData;
+    qint64 mSize;
+    QByteArray mBuffer;
+    Index mIndex;
+};
+
+inline bool LayoutLibrary::isOpen() const { return mData != NULL; }
+inline bool LayoutLibrary::contains(const QString& inName) const { return mIndex.contains(inName); }
+inline QStringList LayoutLibrary::getLayoutNames() const { return mIndex.keys(); }
+inline void LayoutLibrary::remove(const QString& inName) { mIndex.remove(inName); }
+
+} // namespace workspace
+
+#endif // LAYOUT_LIBRARY_HAS_BEEN_INCLUDED
+
@@ -0,0 +1,251 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "PluginCatalog.h"
+
+// Qt
+#include <QDir>
+#include <QJsonObject>
+#include <QLibrary>
+#include <QPluginLoader>
+#include <QtDebug>
+
+// Local
+#include "WorkspaceItem.h"
+
+// Namespaces
+using namespace workspace;
+
+// Constants
+static const char* kPluginIID = "com.ElephantWarehouse.WorkspacePlugin/1.0";
+
+//=============================================================================
+// struct PluginCatalog::Entry
+//=============================================================================
+PluginCatalog::Entry::Entry()
+    :   loader(NULL),
+        plugin(NULL)
+{
+}
+
+
+//=============================================================================
+// class PluginCatalog
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::PluginCatalog()
+//-----------------------------------------------------------------------------
+PluginCatalog::PluginCatalog(Workspace* inWorkspace)
+    :   mWorkspace(inWorkspace)
+{
+    Q_ASSERT(mWorkspace != NULL);
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::~PluginCatalog()
+//
+/// Loaded plugin libraries stay loaded, as items they created may still
+/// be alive.
+//-----------------------------------------------------------------------------
+PluginCatalog::~PluginCatalog()
+{
+    Q_FOREACH(const Entry& theEntry, mEntries)
+        delete theEntry.loader;
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::addDirectory()
+//
+/// Add every plugin library in the directory to the catalog. Only the
+/// metadata of the libraries is read.
+/// \param inDirectory The directory to scan.
+/// \param outAdded If not NULL, receives the plugins that were added.
+/// \result The number of plugins added.
+//-----------------------------------------------------------------------------
+int
+PluginCatalog::addDirectory(const QString& inDirectory, PluginInfoList* outAdded)
+{
+    int theCount = 0;
+
+    const QDir theDir(inDirectory);
+    Q_FOREACH(const QString& theFile, theDir.entryList(QDir::Files)) {
+        const QString thePath = theDir.absoluteFilePath(theFile);
+        if (!QLibrary::isLibrary(thePath))
+            continue;
+
+        PluginInfo theInfo;
+        if (addPlugin(thePath, &theInfo)) {
+            ++theCount;
+            if (outAdded != NULL)
+                outAdded->append(theInfo);
+        }
+    }
+
+    return theCount;
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::addPlugin()
+//
+/// Add a plugin library to the catalog without loading it.
+/// \param inFileName The plugin library.
+/// \param outInfo If not NULL, receives the plugin metadata.
+/// \result True if the library is a WorkspacePlugin with usable metadata
+/// and its class is not in the catalog yet.
+//-----------------------------------------------------------------------------
+bool
+PluginCatalog::addPlugin(const QString& inFileName, PluginInfo* outInfo)
+{
+    QPluginLoader* theLoader = new QPluginLoader(inFileName);
+
+    PluginInfo theInfo;
+    if (!readMetaData(*theLoader, theInfo) || mEntries.contains(theInfo.className)) {
+        delete theLoader;
+        return false;
+    }
+
+    Entry& theEntry = mEntries[theInfo.className];
+    theEntry.info = theInfo;
+    theEntry.loader = theLoader;
+
+    if (outInfo != NULL)
+        *outInfo = theInfo;
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::isLoaded()
+//-----------------------------------------------------------------------------
+bool
+PluginCatalog::isLoaded(const QString& inClassName) const
+{
+    EntryMap::const_iterator iter = mEntries.constFind(inClassName);
+    return iter != mEntries.constEnd() && iter->plugin != NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::getPlugins()
+//-----------------------------------------------------------------------------
+PluginInfoList
+PluginCatalog::getPlugins() const
+{
+    PluginInfoList theList;
+    Q_FOREACH(const Entry& theEntry, mEntries)
+        theList.append(theEntry.info);
+
+    return theList;
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::loadPlugin()
+//
+/// Load the library of the plugin and instantiate it, if not done yet.
+/// \param inClassName The class name from the plugin metadata.
+/// \result The plugin, or NULL if it could not be loaded.
+//-----------------------------------------------------------------------------
+WorkspacePlugin*
+PluginCatalog::loadPlugin(const QString& inClassName)
+{
+    EntryMap::iterator iter = mEntries.find(inClassName);
+    if (iter == mEntries.end())
+        return NULL;
+
+    if (iter->plugin == NULL) {
+        iter->plugin = qobject_cast<WorkspacePlugin*>(iter->loader->instance());
+        if (iter->plugin == NULL)
+            qWarning() << "PluginCatalog: unable to load" << iter->info.fileName
+                       << iter->loader->errorString();
+    }
+
+    return iter->plugin;
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::createItem()
+//
+/// Create a new item of the plugin class, loading the plugin if needed.
+/// \param inClassName The class name from the plugin metadata.
+/// \result The new item, or NULL if the plugin could not be loaded.
+//-----------------------------------------------------------------------------
+WorkspaceItem*
+PluginCatalog::createItem(const QString& inClassName)
+{
+    WorkspacePlugin* thePlugin = loadPlugin(inClassName);
+    if (thePlugin == NULL)
+        return NULL;
+
+    return thePlugin->newItem(mWorkspace);
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::createPanelWidget()
+//
+/// Create the content of a placeholder panel named after a plugin class,
+/// possibly with an instance number.
+//-----------------------------------------------------------------------------
+QWidget*
+PluginCatalog::createPanelWidget(const QString& inName)
+{
+    return createItem(Workspace::getPanelBaseName(inName));
+}
+
+
+//-----------------------------------------------------------------------------
+// PluginCatalog::readMetaData()
+//
+/// Read the metadata of a plugin library without loading it.
+/// \param inLoader The loader for the library.
+/// \param outInfo Receives the metadata.
+/// \result True if the library is a WorkspacePlugin that names its class.
+//-----------------------------------------------------------------------------
+bool
+PluginCatalog::readMetaData(const QPluginLoader& inLoader, PluginInfo& outInfo)
+{
+    const QJsonObject theMetaData = inLoader.metaData();
+    if (theMetaData.value("IID").toString() != QLatin1String(kPluginIID))
+        return false;
+
+    const QJsonObject theUserData = theMetaData.value("MetaData").toObject();
+
+    outInfo.fileName = inLoader.fileName();
+    outInfo.className = theUserData.value("className").toString();
+    outInfo.menuTitle = theUserData.value("menuTitle").toString();
+    outInfo.icon = theUserData.value("icon").toString();
+
+    if (outInfo.className.isEmpty())
+        return false;
+
+    if (outInfo.menuTitle.isEmpty())
+        outInfo.menuTitle = outInfo.className;
+
+    return true;
+}
+
@@ -0,0 +1,117 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef PLUGIN_CATALOG_HAS_BEEN_INCLUDED
+#define PLUGIN_CATALOG_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QList>
+#include <QMap>
+#include <QString>
+
+// Local
+#include "Workspace.h"
+
+// Forward declarations
+class QPluginLoader;
+
+namespace workspace {
+
+// Forward declarations
+class WorkspaceItem;
+class WorkspacePlugin;
+
+//=============================================================================
+// struct PluginInfo
+//=============================================================================
+/*! What is known about a plugin before its library is loaded.
+    This is read from the JSON metadata the plugin declares with
+    Q_PLUGIN_METADATA, for example:
+
+        { "className": "Histogram", "menuTitle": "Histogram",
+          "icon": ":/icons/histogram.png" }
+*/
+struct PluginInfo
+{
+    QString fileName;
+    QString className;
+    QString menuTitle;
+    QString icon;
+};
+
+typedef QList<PluginInfo> PluginInfoList;
+
+//=============================================================================
+// class PluginCatalog
+//=============================================================================
+/*! Knows about WorkspacePlugins without loading them.
+    Plugin libraries are scanned for their metadata only. A library is
+    loaded and its plugin instantiated the first time an item of its
+    class is created, either from the panel creation menu or because a
+    restored layout shows a panel of that class. The catalog is a
+    PanelFactory for the class names of its plugins.
+*/
+class PluginCatalog : public PanelFactory
+{
+public:
+    PluginCatalog(Workspace* inWorkspace);
+    virtual ~PluginCatalog();
+
+    int addDirectory(const QString& inDirectory, PluginInfoList* outAdded = NULL);
+    bool addPlugin(const QString& inFileName, PluginInfo* outInfo = NULL);
+
+    bool contains(const QString& inClassName) const;
+    bool isLoaded(const QString& inClassName) const;
+    PluginInfoList getPlugins() const;
+
+    WorkspacePlugin* loadPlugin(const QString& inClassName);
+    WorkspaceItem* createItem(const QString& inClassName);
+
+    // PanelFactory
+    virtual QWidget* createPanelWidget(const QString& inName);
+
+private:
+    // No copying
+    PluginCatalog(const PluginCatalog& c);
+    PluginCatalog& operator = (const PluginCatalog& c);
+
+    struct Entry
+    {
+        Entry();
+
+        PluginInfo info;
+        QPluginLoader* loader;
+        WorkspacePlugin* plugin;
+    };
+
+    typedef QMap<QString, Entry> EntryMap;
+
+    static bool readMetaData(const QPluginLoader& inLoader, PluginInfo& outInfo);
+
+    Workspace* mWorkspace;
+    EntryMap mEntries;
+};
+
+inline bool PluginCatalog::contains(const QString& inClassName) const { return mEntries.contains(inClassName); }
+
+} // namespace workspace
+
+#endif // PLUGIN_CATALOG_HAS_BEEN_INCLUDED
+
@@ -0,0 +1,130 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "ProgressClock.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QPointer>
+
+// Time between two indicator frames
+static const int kTickInterval = 80;
+
+//=============================================================================
+// class ProgressClock
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// ProgressClock::instance()
+//
+/// Return the clock shared by the application.
+//-----------------------------------------------------------------------------
+ProgressClock*
+ProgressClock::instance()
+{
+    // Made again for a new application object
+    static QPointer<ProgressClock> sInstance;
+    if (sInstance.isNull())
+        sInstance = new ProgressClock();
+
+    return sInstance;
+}
+
+
+//-----------------------------------------------------------------------------
+// ProgressClock::ProgressClock()
+//-----------------------------------------------------------------------------
+ProgressClock::ProgressClock()
+    :   QObject(QCoreApplication::instance())
+    ,   mPhase(0)
+{
+    mTimer.setInterval(kTickInterval);
+    connect(&mTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+
+//-----------------------------------------------------------------------------
+// ProgressClock::attach()
+//
+/// Start driving a client. Attaching the same client again is ignored.
+/// \param inClient The client.
+/// \param inMember The slot to call on every tick, given with SLOT(). It
+/// takes the phase as an int.
+//-----------------------------------------------------------------------------
+void
+ProgressClock::attach(QObject* inClient, const char* inMember)
+{
+    Q_ASSERT(inClient != NULL);
+
+    if (mClients.contains(inClient))
+        return;
+
+    mClients.insert(inClient);
+    connect(this, SIGNAL(tick(int)), inClient, inMember);
+    connect(inClient, SIGNAL(destroyed(QObject*)), this, SLOT(onClientDestroyed(QObject*)));
+
+    if (!mTimer.isActive())
+        mTimer.start();
+}
+
+
+//-----------------------------------------------------------------------------
+// ProgressClock::detach()
+//
+/// Stop driving a client. The clock stops with the last client.
+//-----------------------------------------------------------------------------
+void
+ProgressClock::detach(QObject* inClient)
+{
+    if (!mClients.remove(inClient))
+        return;
+
+    disconnect(this, NULL, inClient, NULL);
+    disconnect(inClient, NULL, this, NULL);
+
+    if (mClients.isEmpty())
+        mTimer.stop();
+}
+
+
+//-----------------------------------------------------------------------------
+// ProgressClock::onTimeout() [slot]
+//-----------------------------------------------------------------------------
+void
+ProgressClock::onTimeout()
+{
+    mPhase = (mPhase + 1) % PhaseCount;
+    Q_EMIT tick(mPhase);
+}
+
+
+//-----------------------------------------------------------------------------
+// ProgressClock::onClientDestroyed() [slot]
+//-----------------------------------------------------------------------------
+void
+ProgressClock::onClientDestroyed(QObject* inClient)
+{
+    mClients.remove(inClient);
+
+    if (mClients.isEmpty())
+        mTimer.stop();
+}
+
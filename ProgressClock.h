@@ -0,0 +1,71 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef PROGRESS_CLOCK_HAS_BEEN_INCLUDED
+#define PROGRESS_CLOCK_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+//=============================================================================
+// class ProgressClock
+//=============================================================================
+/// \brief The one clock that animates all busy indicators.
+///
+/// Clients attach a slot taking the current phase. The clock only runs
+/// while at least one client is attached, and every client is driven by
+/// the same tick, however many indicators are spinning.
+///
+class ProgressClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int PhaseCount = 12;
+
+    static ProgressClock* instance();
+
+    void attach(QObject* inClient, const char* inMember);
+    void detach(QObject* inClient);
+
+    int phase() const;
+
+Q_SIGNALS:
+    void tick(int inPhase);
+
+private Q_SLOTS:
+    void onTimeout();
+    void onClientDestroyed(QObject* inClient);
+
+private:
+    ProgressClock();
+    Q_DISABLE_COPY(ProgressClock)
+
+    QTimer mTimer;
+    QSet<QObject*> mClients;
+    int mPhase;
+};
+
+inline int ProgressClock::phase() const { return mPhase; }
+
+#endif // !PROGRESS_CLOCK_HAS_BEEN_INCLUDED
+
@@ -0,0 +1,170 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "RenderingProfile.h"
+
+// Qt
+#include <QApplication>
+#include <QPaintEvent>
+#include <QPointer>
+#include <QWidget>
+
+//=============================================================================
+// struct PixelThroughput
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// PixelThroughput::PixelThroughput()
+//-----------------------------------------------------------------------------
+PixelThroughput::PixelThroughput()
+    :   paints(0)
+    ,   pixels(0)
+    ,   bytes(0)
+{
+}
+
+
+//=============================================================================
+// class RenderingProfile
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// RenderingProfile::instance()
+//
+/// Return the profile shared by the application.
+//-----------------------------------------------------------------------------
+RenderingProfile*
+RenderingProfile::instance()
+{
+    // Made again for a new application object
+    static QPointer<RenderingProfile> sInstance;
+    if (sInstance.isNull())
+        sInstance = new RenderingProfile();
+
+    return sInstance;
+}
+
+
+//-----------------------------------------------------------------------------
+// RenderingProfile::RenderingProfile()
+//-----------------------------------------------------------------------------
+RenderingProfile::RenderingProfile()
+    :   QObject(QCoreApplication::instance())
+    ,   mProfile(ProfileStandard)
+    ,   mSavedPerformanceMode(AnimationMonitor::PerformanceAuto)
+    ,   mPixelCounting(false)
+{
+}
+
+
+//-----------------------------------------------------------------------------
+// RenderingProfile::setProfile()
+//
+/// Switch the rendering profile of the application and repaint it. The
+/// animation performance mode in effect before the low bandwidth profile
+/// is restored when leaving it.
+/// \param inProfile The profile.
+//-----------------------------------------------------------------------------
+void
+RenderingProfile::setProfile(Profile inProfile)
+{
+    if (inProfile == mProfile)
+        return;
+
+    mProfile = inProfile;
+    const bool lowBandwidth = isLowBandwidth();
+
+    // Layout animations, drop indicator fades and drop zone prelighting
+    AnimationMonitor* theMonitor = AnimationMonitor::instance();
+    if (lowBandwidth) {
+        mSavedPerformanceMode = theMonitor->getPerformanceMode();
+        theMonitor->setPerformanceMode(AnimationMonitor::PerformanceOff);
+    } else {
+        theMonitor->setPerformanceMode(mSavedPerformanceMode);
+    }
+
+    // FrameworkStyle asks for the profile when it paints, flat fills
+    // instead of gradients only need a repaint
+    Q_FOREACH(QWidget* theWidget, QApplication::topLevelWidgets())
+        theWidget->update();
+
+    Q_EMIT profileChanged(inProfile);
+}
+
+
+//-----------------------------------------------------------------------------
+// RenderingProfile::setPixelCounting()
+//
+/// Start or stop counting the pixels painted by every widget of the
+/// application. Widgets that overlap are each counted, so the figures
+/// are an upper bound on what is sent to the display.
+/// \param inCounting True to count.
+/// \sa getPixelThroughput
+//-----------------------------------------------------------------------------
+void
+RenderingProfile::setPixelCounting(bool inCounting)
+{
+    if (inCounting == mPixelCounting)
+        return;
+
+    mPixelCounting = inCounting;
+
+    // Only filter the application's events while they are counted
+    if (mPixelCounting)
+        QCoreApplication::instance()->installEventFilter(this);
+    else
+        QCoreApplication::instance()->removeEventFilter(this);
+}
+
+
+//-----------------------------------------------------------------------------
+// RenderingProfile::resetPixelThroughput()
+//
+/// Zero the pixel counters, typically before an interaction is measured.
+//-----------------------------------------------------------------------------
+void
+RenderingProfile::resetPixelThroughput()
+{
+    mPixelThroughput = PixelThroughput();
+}
+
+
+//-----------------------------------------------------------------------------
+// RenderingProfile::eventFilter()
+//-----------------------------------------------------------------------------
+bool
+RenderingProfile::eventFilter(QObject* inObject, QEvent* inEvent)
+{
+    if (inEvent->type() == QEvent::Paint && inObject->isWidgetType()) {
+        const QWidget* theWidget = static_cast<QWidget*>(inObject);
+        const QRegion& theRegion = static_cast<QPaintEvent*>(inEvent)->region();
+
+        qint64 thePixels = 0;
+        Q_FOREACH(const QRect& theRect, theRegion.rects())
+            thePixels += qint64(theRect.width()) * theRect.height();
+
+        ++mPixelThroughput.paints;
+        mPixelThroughput.pixels += thePixels;
+        mPixelThroughput.bytes += thePixels * ((theWidget->depth() + 7) / 8);
+    }
+
+    return QObject::eventFilter(inObject, inEvent);
+}
@@ -0,0 +1,100 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef RENDERING_PROFILE_HAS_BEEN_INCLUDED
+#define RENDERING_PROFILE_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QObject>
+
+// Local
+#include "AnimationMonitor.h"
+
+//=============================================================================
+// struct PixelThroughput
+//=============================================================================
+/*! Counters for the pixels painted by the application.
+    \sa RenderingProfile::setPixelCounting
+*/
+struct PixelThroughput
+{
+    PixelThroughput();
+
+    int paints;         // paint events delivered to widgets
+    qint64 pixels;      // pixels in the regions of those events
+    qint64 bytes;       // bytes of those pixels at the widgets' depth
+};
+
+//=============================================================================
+// class RenderingProfile
+//=============================================================================
+/// \brief How much the workspace draws, chosen for the display it runs on.
+///
+/// The low bandwidth profile is meant for X forwarding and VNC, where
+/// every changed pixel crosses the network. It turns off the layout
+/// animations and the drop indicator fades, the gradients of the
+/// FrameworkStyle and the hover colorizing of DynamicPixmapItems.
+///
+/// A pixel counter can be switched on to measure the bytes painted by
+/// an interaction, under either profile.
+///
+class RenderingProfile : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Profile {
+        ProfileStandard,
+        ProfileLowBandwidth
+    };
+
+    static RenderingProfile* instance();
+
+    void setProfile(Profile inProfile);
+    Profile getProfile() const;
+    bool isLowBandwidth() const;
+
+    void setPixelCounting(bool inCounting);
+    bool isPixelCounting() const;
+    const PixelThroughput& getPixelThroughput() const;
+    void resetPixelThroughput();
+
+Q_SIGNALS:
+    void profileChanged(RenderingProfile::Profile inProfile);
+
+protected:
+    virtual bool eventFilter(QObject* inObject, QEvent* inEvent);
+
+private:
+    RenderingProfile();
+    Q_DISABLE_COPY(RenderingProfile)
+
+    Profile mProfile;
+    AnimationMonitor::PerformanceMode mSavedPerformanceMode;
+    bool mPixelCounting;
+    PixelThroughput mPixelThroughput;
+};
+
+inline RenderingProfile::Profile RenderingProfile::getProfile() const { return mProfile; }
+inline bool RenderingProfile::isLowBandwidth() const { return mProfile == ProfileLowBandwidth; }
+inline bool RenderingProfile::isPixelCounting() const { return mPixelCounting; }
+inline const PixelThroughput& RenderingProfile::getPixelThroughput() const { return mPixelThroughput; }
+
+#endif // !RENDERING_PROFILE_HAS_BEEN_INCLUDED
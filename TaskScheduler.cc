@@ -0,0 +1,323 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "TaskScheduler.h"
+
+// Qt
+#include <QGuiApplication>
+#include <QMetaObject>
+
+// Constants
+static const int kMaxSlack = 1000;
+static const int kIdleBudget = 5;
+
+//=============================================================================
+// class TaskScheduler
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::instance()
+//
+/// Return the scheduler shared by the application.
+//-----------------------------------------------------------------------------
+TaskScheduler*
+TaskScheduler::instance()
+{
+    // The scheduler goes away with the application object, and a new one
+    // is made for the next application
+    static QPointer<TaskScheduler> sInstance;
+    if (sInstance.isNull())
+        sInstance = new TaskScheduler();
+
+    return sInstance;
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::TaskScheduler()
+//-----------------------------------------------------------------------------
+TaskScheduler::TaskScheduler()
+    :   QObject(QCoreApplication::instance())
+    ,   mNextTaskId(1)
+    ,   mPaused(false)
+    ,   mApplicationState(Qt::ApplicationActive)
+{
+    mClock.start();
+
+    mTimer.setSingleShot(true);
+    connect(&mTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+
+    mIdleTimer.setSingleShot(true);
+    mIdleTimer.setInterval(0);
+    connect(&mIdleTimer, SIGNAL(timeout()), this, SLOT(onIdle()));
+
+    if (qGuiApp != NULL) {
+        mApplicationState = qGuiApp->applicationState();
+        connect(qGuiApp, SIGNAL(applicationStateChanged(Qt::ApplicationState)),
+                this, SLOT(onApplicationStateChanged(Qt::ApplicationState)));
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::schedule()
+//
+/// Invoke a slot after a delay.
+/// \param inReceiver The object to invoke the slot on. The task is
+/// dropped if the object is destroyed.
+/// \param inMember The slot, given with SLOT(). It takes no arguments.
+/// \param inDelay The delay in msecs. The task may run up to an eighth of
+/// the delay late, so it can share a wakeup with other tasks.
+/// \param inFlags Repeat and inactive behavior. Only one-shot tasks may
+/// run while inactive.
+/// \result The id of the task, used to cancel it.
+//-----------------------------------------------------------------------------
+int
+TaskScheduler::schedule(QObject* inReceiver, 
+                        const char* inMember, 
+                        int inDelay, 
+                        TaskFlags inFlags)
+{
+    Q_ASSERT(inReceiver != NULL);
+    Q_ASSERT(inMember != NULL);
+    Q_ASSERT(!(inFlags.testFlag(Repeat) && inFlags.testFlag(RunWhenInactive)));
+
+    Task theTask;
+    theTask.receiver = inReceiver;
+    theTask.member = getMethodName(inMember);
+    theTask.delay = qMax(0, inDelay);
+    theTask.flags = inFlags;
+    theTask.deadline = mClock.elapsed() + theTask.delay;
+    theTask.latest = theTask.deadline + getSlack(theTask.delay);
+
+    const int theTaskId = mNextTaskId++;
+    mTasks.insert(theTaskId, theTask);
+    rearm();
+
+    return theTaskId;
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::cancel()
+//-----------------------------------------------------------------------------
+void
+TaskScheduler::cancel(int inTaskId)
+{
+    if (mTasks.remove(inTaskId) != 0)
+        rearm();
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::postIdleTask()
+//
+/// Invoke a slot once the event loop is idle. Idle tasks run in the order
+/// they were posted, a few milliseconds' worth at a time.
+/// \param inReceiver The object to invoke the slot on.
+/// \param inMember The slot, given with SLOT(). It takes no arguments.
+//-----------------------------------------------------------------------------
+void
+TaskScheduler::postIdleTask(QObject* inReceiver, const char* inMember)
+{
+    Q_ASSERT(inReceiver != NULL);
+    Q_ASSERT(inMember != NULL);
+
+    IdleTask theTask;
+    theTask.receiver = inReceiver;
+    theTask.member = getMethodName(inMember);
+    mIdleTasks.append(theTask);
+
+    if (!mIdleTimer.isActive())
+        rearm();
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::setPaused()
+//
+/// Pause or resume all tasks. Tasks that fell due while paused run on
+/// the first wakeup after resuming.
+//-----------------------------------------------------------------------------
+void
+TaskScheduler::setPaused(bool inPaused)
+{
+    if (inPaused == mPaused)
+        return;
+
+    mPaused = inPaused;
+    rearm();
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::isRunning()
+//
+/// \result True unless paused or the application is not the active one.
+//-----------------------------------------------------------------------------
+bool
+TaskScheduler::isRunning() const
+{
+    return !mPaused && mApplicationState == Qt::ApplicationActive;
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::canRun()
+//
+/// \result True if the task may run now.
+//-----------------------------------------------------------------------------
+bool
+TaskScheduler::canRun(const Task& inTask) const
+{
+    return isRunning() || inTask.flags.testFlag(RunWhenInactive);
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::rearm()
+//
+/// Set the timer for the latest time the earliest runnable task accepts.
+//-----------------------------------------------------------------------------
+void
+TaskScheduler::rearm()
+{
+    qint64 theWakeup = -1;
+    Q_FOREACH(const Task& theTask, mTasks) {
+        if (canRun(theTask) && (theWakeup == -1 || theTask.latest < theWakeup))
+            theWakeup = theTask.latest;
+    }
+
+    if (theWakeup == -1) {
+        mTimer.stop();
+    } else {
+        mTimer.start(int(qMax(qint64(0), theWakeup - mClock.elapsed())));
+    }
+
+    if (!isRunning())
+        mIdleTimer.stop();
+    else if (!mIdleTasks.isEmpty() && !mIdleTimer.isActive())
+        mIdleTimer.start();
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::onTimeout() [slot]
+//
+/// Run every runnable task that is due, then wait for the next one.
+//-----------------------------------------------------------------------------
+void
+TaskScheduler::onTimeout()
+{
+    const qint64 theNow = mClock.elapsed();
+
+    QList<int> theDueTasks;
+    QMapIterator<int, Task> iter(mTasks);
+    while (iter.hasNext()) {
+        iter.next();
+        if (iter.value().deadline <= theNow && canRun(iter.value()))
+            theDueTasks.append(iter.key());
+    }
+
+    Q_FOREACH(int theTaskId, theDueTasks) {
+        // An earlier task may have canceled this one
+        QMap<int, Task>::iterator theTask = mTasks.find(theTaskId);
+        if (theTask == mTasks.end())
+            continue;
+
+        QPointer<QObject> theReceiver = theTask->receiver;
+        const QByteArray theMember = theTask->member;
+
+        if (theReceiver == NULL || !theTask->flags.testFlag(Repeat)) {
+            mTasks.erase(theTask);
+        } else {
+            theTask->deadline = theNow + theTask->delay;
+            theTask->latest = theTask->deadline + getSlack(theTask->delay);
+        }
+
+        if (theReceiver != NULL)
+            QMetaObject::invokeMethod(theReceiver, theMember.constData(), Qt::DirectConnection);
+    }
+
+    rearm();
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::onIdle() [slot]
+//-----------------------------------------------------------------------------
+void
+TaskScheduler::onIdle()
+{
+    QElapsedTimer theBudget;
+    theBudget.start();
+
+    while (!mIdleTasks.isEmpty() && theBudget.elapsed() < kIdleBudget) {
+        const IdleTask theTask = mIdleTasks.takeFirst();
+        if (theTask.receiver != NULL)
+            QMetaObject::invokeMethod(theTask.receiver, theTask.member.constData(), Qt::DirectConnection);
+    }
+
+    // Let pending events through before running more
+    if (!mIdleTasks.isEmpty())
+        rearm();
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::onApplicationStateChanged() [slot]
+//-----------------------------------------------------------------------------
+void
+TaskScheduler::onApplicationStateChanged(Qt::ApplicationState inState)
+{
+    mApplicationState = inState;
+    rearm();
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::getMethodName()
+//
+/// Strip the SLOT() code and argument list from a member.
+//-----------------------------------------------------------------------------
+QByteArray
+TaskScheduler::getMethodName(const char* inMember)
+{
+    QByteArray theName(inMember + 1);
+    const int argsStart = theName.indexOf('(');
+    if (argsStart != -1)
+        theName.truncate(argsStart);
+
+    return theName;
+}
+
+
+//-----------------------------------------------------------------------------
+// TaskScheduler::getSlack()
+//
+/// How late a task with the given delay may run.
+//-----------------------------------------------------------------------------
+int
+TaskScheduler::getSlack(int inDelay)
+{
+    return qMin(inDelay / 8, kMaxSlack);
+}
+
@@ -0,0 +1,122 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef TASK_SCHEDULER_HAS_BEEN_INCLUDED
+#define TASK_SCHEDULER_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+//=============================================================================
+// class TaskScheduler
+//=============================================================================
+/// \brief The one timer behind the workspace's delayed and periodic work.
+///
+/// Tasks are slots invoked after a delay. Every task may run a little
+/// late, by up to an eighth of its delay, so tasks that fall due close
+/// together are run on a single wakeup. Nothing runs while the scheduler
+/// is paused, for example while the main window is minimized, or while
+/// the application is not the active one. Tasks that fell due meanwhile
+/// run on the first wakeup after that. The exception are one-shot tasks
+/// flagged RunWhenInactive, such as saving state, which should not wait
+/// for the user to come back. Idle tasks are run in small batches once
+/// the event loop has nothing else to do.
+///
+class TaskScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum TaskFlag {
+        NoFlags         = 0x00,
+        Repeat          = 0x01,     ///< Run every delay until canceled
+        RunWhenInactive = 0x02      ///< Run on time even while paused or inactive
+    };
+    Q_DECLARE_FLAGS(TaskFlags, TaskFlag)
+
+    static TaskScheduler* instance();
+
+    int schedule(QObject* inReceiver, 
+                 const char* inMember, 
+                 int inDelay, 
+                 TaskFlags inFlags = NoFlags);
+    void cancel(int inTaskId);
+    bool isScheduled(int inTaskId) const;
+
+    void postIdleTask(QObject* inReceiver, const char* inMember);
+
+    void setPaused(bool inPaused);
+    bool isPaused() const;
+
+private Q_SLOTS:
+    void onTimeout();
+    void onIdle();
+    void onApplicationStateChanged(Qt::ApplicationState inState);
+
+private:
+    TaskScheduler();
+    Q_DISABLE_COPY(TaskScheduler)
+
+    struct Task
+    {
+        QPointer<QObject> receiver;
+        QByteArray member;
+        int delay;
+        TaskFlags flags;
+        qint64 deadline;
+        qint64 latest;
+    };
+
+    struct IdleTask
+    {
+        QPointer<QObject> receiver;
+        QByteArray member;
+    };
+
+    bool isRunning() const;
+    bool canRun(const Task& inTask) const;
+    void rearm();
+
+    static QByteArray getMethodName(const char* inMember);
+    static int getSlack(int inDelay);
+
+    QMap<int, Task> mTasks;
+    QList<IdleTask> mIdleTasks;
+    QTimer mTimer;
+    QTimer mIdleTimer;
+    QElapsedTimer mClock;
+    int mNextTaskId;
+    bool mPaused;
+    Qt::ApplicationState mApplicationState;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TaskScheduler::TaskFlags)
+
+inline bool TaskScheduler::isScheduled(int inTaskId) const { return mTasks.contains(inTaskId); }
+inline bool TaskScheduler::isPaused() const { return mPaused; }
+
+#endif // !TASK_SCHEDULER_HAS_BEEN_INCLUDED
+
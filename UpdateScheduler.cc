@@ -0,0 +1,367 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Self
+#include "UpdateScheduler.h"
+
+// Qt
+#include <QList>
+#include <QMetaObject>
+#include <QtAlgorithms>
+#include <QTimer>
+
+// Local
+#include "WorkspaceArea.h"
+
+// Namespaces
+using namespace workspace;
+
+// Constants
+static const int kDefaultFrameInterval = 16;
+static const int kDefaultUpdatesPerFrame = 8;
+
+// Visible panels that are not focused are updated every kReducedDivisor
+// frames, or every kLargeDivisor frames when they cover at least
+// 1/kLargePanelFraction of the workspace area.
+static const int kReducedDivisor = 4;
+static const int kLargeDivisor = 2;
+static const int kLargePanelFraction = 4;
+
+namespace {
+
+    /// A client that is due for an update in the current frame
+    ///
+    struct DueClient {
+        WorkspacePanel* panel;
+        int divisor;
+        uint waited;
+    };
+
+    /// Order due clients by rate, then by how long they have waited
+    ///
+    bool dueClientLessThan(const DueClient& inLeft, const DueClient& inRight)
+    {
+        if (inLeft.divisor != inRight.divisor)
+            return inLeft.divisor < inRight.divisor;
+        return inLeft.waited > inRight.waited;
+    }
+
+} // anonymous namespace
+
+
+//=============================================================================
+// struct UpdateScheduler::Client
+//=============================================================================
+UpdateScheduler::Client::Client()
+    :   pending(false),
+        lastFrame(0)
+{
+}
+
+
+//=============================================================================
+// class UpdateScheduler
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::UpdateScheduler()
+//
+/// Create a scheduler for the panels of a workspace area.
+/// \param inArea The area used to determine focus and relative size.
+/// \param inParent The parent object.
+//-----------------------------------------------------------------------------
+UpdateScheduler::UpdateScheduler(WorkspaceArea* inArea, QObject* inParent)
+    :   QObject(inParent),
+        mArea(inArea),
+        mFrameTimer(NULL),
+        mFrame(0),
+        mUpdatesPerFrame(kDefaultUpdatesPerFrame)
+{
+    mFrameTimer = new QTimer(this);
+    mFrameTimer->setInterval(kDefaultFrameInterval);
+    connect(mFrameTimer, SIGNAL(timeout()), this, SLOT(onFrame()));
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::~UpdateScheduler()
+//-----------------------------------------------------------------------------
+UpdateScheduler::~UpdateScheduler()
+{
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::registerPanel()
+//
+/// Register a panel with the scheduler. The member is invoked on the
+/// receiver whenever the panel is granted an update.
+/// \param inPanel The panel hosting the content.
+/// \param inReceiver The object that performs the update.
+/// \param inMember The update slot, given with SLOT(). It takes no arguments.
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::registerPanel(WorkspacePanel* inPanel,
+                               QObject* inReceiver,
+                               const char* inMember)
+{
+    Q_ASSERT(inPanel != NULL);
+    Q_ASSERT(inReceiver != NULL);
+    Q_ASSERT(inMember != NULL);
+
+    // Strip the SLOT() code and the argument list, leaving the method name
+    QByteArray theMember(inMember + 1);
+    const int argsStart = theMember.indexOf('(');
+    if (argsStart != -1)
+        theMember.truncate(argsStart);
+
+    if (!mClients.contains(inPanel)) {
+        connect(inPanel, SIGNAL(exposureChanged(WorkspacePanel::Exposure)),
+                this, SLOT(onExposureChanged(WorkspacePanel::Exposure)));
+        connect(inPanel, SIGNAL(destroyed(QObject*)), this, SLOT(onPanelDestroyed(QObject*)));
+    }
+
+    Client& theClient = mClients[inPanel];
+    theClient.receiver = inReceiver;
+    theClient.member = theMember;
+    theClient.lastFrame = mFrame;
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::unregisterPanel()
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::unregisterPanel(WorkspacePanel* inPanel)
+{
+    if (mClients.remove(inPanel) == 0)
+        return;
+
+    disconnect(inPanel, NULL, this, NULL);
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::requestUpdate()
+//
+/// Mark the panel as needing an update. Requests made before the panel
+/// is granted its update are merged into one.
+/// \param inPanel The registered panel.
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::requestUpdate(WorkspacePanel* inPanel)
+{
+    ClientMap::iterator iter = mClients.find(inPanel);
+    if (iter == mClients.end())
+        return;
+
+    iter->pending = true;
+
+    if (getFrameDivisor(inPanel) != 0)
+        startFrames();
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::getRate()
+//
+/// Return the update rate the panel is currently entitled to.
+/// \param inPanel The panel.
+//-----------------------------------------------------------------------------
+UpdateScheduler::Rate
+UpdateScheduler::getRate(WorkspacePanel* inPanel) const
+{
+    switch (getFrameDivisor(inPanel)) {
+        case 0:
+            return RateNone;
+
+        case 1:
+            return RateFull;
+
+        default:
+            return RateReduced;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::setFrameInterval()
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::setFrameInterval(int inMilliseconds)
+{
+    mFrameTimer->setInterval(qMax(1, inMilliseconds));
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::frameInterval()
+//-----------------------------------------------------------------------------
+int
+UpdateScheduler::frameInterval() const
+{
+    return mFrameTimer->interval();
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::setUpdatesPerFrame()
+//
+/// Set the maximum number of panels updated in a single frame. Panels
+/// that miss out are served first in the following frame.
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::setUpdatesPerFrame(int inUpdates)
+{
+    mUpdatesPerFrame = qMax(1, inUpdates);
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::getFrameDivisor()
+//
+/// Return how many frames apart the panel may be updated, or 0 if it
+/// may not be updated at all.
+//-----------------------------------------------------------------------------
+int
+UpdateScheduler::getFrameDivisor(WorkspacePanel* inPanel) const
+{
+    if (inPanel->exposure() != WorkspacePanel::ExposureVisible)
+        return 0;
+
+    if (mArea == NULL)
+        return kReducedDivisor;
+
+    if (inPanel == mArea->getActivePanel())
+        return 1;
+
+    const QSize panelSize = inPanel->size();
+    const QSize areaSize = mArea->size();
+    const qint64 panelArea = qint64(panelSize.width()) * panelSize.height();
+    const qint64 workspaceArea = qint64(areaSize.width()) * areaSize.height();
+    if (panelArea * kLargePanelFraction >= workspaceArea)
+        return kLargeDivisor;
+
+    return kReducedDivisor;
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::startFrames()
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::startFrames()
+{
+    if (!mFrameTimer->isActive())
+        mFrameTimer->start();
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::onFrame() [slot]
+//
+/// Grant updates to the pending panels that are due in this frame, in
+/// order of rate and waiting time, up to the per frame budget.
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::onFrame()
+{
+    ++mFrame;
+
+    QList<DueClient> theDueClients;
+    bool waiting = false;
+
+    for (ClientMap::iterator iter = mClients.begin(); iter != mClients.end(); ++iter) {
+        if (!iter->pending)
+            continue;
+
+        const int theDivisor = getFrameDivisor(iter.key());
+        if (theDivisor == 0)
+            continue;
+
+        const uint theWaited = mFrame - iter->lastFrame;
+        if (theWaited < uint(theDivisor)) {
+            waiting = true;
+            continue;
+        }
+
+        DueClient theDue = { iter.key(), theDivisor, theWaited };
+        theDueClients.append(theDue);
+    }
+
+    qSort(theDueClients.begin(), theDueClients.end(), dueClientLessThan);
+
+    int theUpdates = 0;
+    Q_FOREACH(const DueClient& theDue, theDueClients) {
+        if (theUpdates == mUpdatesPerFrame) {
+            waiting = true;
+            break;
+        }
+
+        // The update slot may unregister the panel
+        ClientMap::iterator iter = mClients.find(theDue.panel);
+        if (iter == mClients.end())
+            continue;
+
+        iter->pending = false;
+        iter->lastFrame = mFrame;
+        QPointer<QObject> theReceiver = iter->receiver;
+        const QByteArray theMember = iter->member;
+
+        if (theReceiver != NULL) {
+            QMetaObject::invokeMethod(theReceiver, theMember.constData(), Qt::DirectConnection);
+            ++theUpdates;
+        }
+    }
+
+    // Stop ticking once nothing visible is waiting for an update. Requests
+    // made by the update slots themselves have restarted the timer.
+    if (!waiting && theUpdates == 0)
+        mFrameTimer->stop();
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::onExposureChanged() [slot]
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::onExposureChanged(WorkspacePanel::Exposure inExposure)
+{
+    if (inExposure != WorkspacePanel::ExposureVisible)
+        return;
+
+    // Serve updates that were held back while the panel was not visible
+    WorkspacePanel* thePanel = qobject_cast<WorkspacePanel*>(sender());
+    ClientMap::const_iterator iter = mClients.constFind(thePanel);
+    if (iter != mClients.constEnd() && iter->pending)
+        startFrames();
+}
+
+
+//-----------------------------------------------------------------------------
+// UpdateScheduler::onPanelDestroyed() [slot]
+//-----------------------------------------------------------------------------
+void
+UpdateScheduler::onPanelDestroyed(QObject* inObject)
+{
+    // The panel is already partly destroyed, so only use it as a key
+    mClients.remove(static_cast<WorkspacePanel*>(inObject));
+}
+
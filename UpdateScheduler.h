@@ -0,0 +1,115 @@
+/*
+The MIT License (MIT)
+Copyright (c) 2011 Gene Z. Ragan
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef UPDATE_SCHEDULER_HAS_BEEN_INCLUDED
+#define UPDATE_SCHEDULER_HAS_BEEN_INCLUDED
+
+// Qt
+#include <QByteArray>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+
+// Local
+#include "WorkspacePanel.h"
+
+// Forward declarations
+class QTimer;
+class WorkspaceArea;
+
+namespace workspace {
+
+//=============================================================================
+// class UpdateScheduler
+//=============================================================================
+/*! Hands out update budgets to live panels.
+    Instead of running their own timers, panels register an update slot
+    and call requestUpdate() when their data changes. A single frame timer
+    then calls the slots, at most a fixed number per frame. The focused
+    panel is updated every frame, other visible panels at a reduced rate
+    that depends on their size, and occluded, background or suspended
+    panels not at all until they become visible again.
+*/
+class UpdateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Rate {
+        RateFull,
+        RateReduced,
+        RateNone
+    };
+
+    UpdateScheduler(WorkspaceArea* inArea, QObject* inParent = NULL);
+    virtual ~UpdateScheduler();
+
+    void registerPanel(WorkspacePanel* inPanel, QObject* inReceiver, const char* inMember);
+    void unregisterPanel(WorkspacePanel* inPanel);
+    bool isRegistered(WorkspacePanel* inPanel) const;
+
+    void requestUpdate(WorkspacePanel* inPanel);
+    Rate getRate(WorkspacePanel* inPanel) const;
+
+    void setFrameInterval(int inMilliseconds);
+    int frameInterval() const;
+
+    void setUpdatesPerFrame(int inUpdates);
+    int updatesPerFrame() const;
+
+private Q_SLOTS:
+    void onFrame();
+    void onExposureChanged(WorkspacePanel::Exposure inExposure);
+    void onPanelDestroyed(QObject* inObject);
+
+private:
+    // No copying
+    UpdateScheduler(const UpdateScheduler& c);
+    UpdateScheduler& operator = (const UpdateScheduler& c);
+
+    struct Client
+    {
+        Client();
+
+        QPointer<QObject> receiver;
+        QByteArray member;
+        bool pending;
+        uint lastFrame;
+    };
+
+    typedef QMap<WorkspacePanel*, Client> ClientMap;
+
+    int getFrameDivisor(WorkspacePanel* inPanel) const;
+    void startFrames();
+
+    QPointer<WorkspaceArea> mArea;
+    ClientMap mClients;
+    QTimer* mFrameTimer;
+    uint mFrame;
+    int mUpdatesPerFrame;
+};
+
+inline bool UpdateScheduler::isRegistered(WorkspacePanel* inPanel) const { return mClients.contains(inPanel); }
+inline int UpdateScheduler::updatesPerFrame() const { return mUpdatesPerFrame; }
+
+} // namespace workspace
+
+#endif // UPDATE_SCHEDULER_HAS_BEEN_INCLUDED
+
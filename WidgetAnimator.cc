@@ -22,7 +22,9 @@ THE SOFTWARE.
 #include "WidgetAnimator.h"
 
 // Qt
-#include <QPropertyAnimation>
+#include <QApplication>
+#include <QPainter>
+#include <QPaintEvent>
 #include <QtDebug>
 #include <QWidget>
 
@@ -30,48 +32,157 @@ THE SOFTWARE.
 #include "DynamicGridLayout.h"
 
 
-// Set the default animation time
+// Set the default animation time, before the AnimationMonitor shortens it
 static const int kAnimationDuration = 200;
 
+// Time between two animation frames
+static const int kFrameInterval = 16;
+
+// Number of widgets that can move without growing the motion list
+static const int kReservedMotions = 32;
+
+//=============================================================================
+// class WidgetProxy
+//=============================================================================
+/// \brief Stands in for a moving widget with an image of it.
+///
+class WidgetProxy : public QWidget
+{
+public:
+    WidgetProxy(QWidget* inParent) : QWidget(inParent) 
+    {
+        setAttribute(Qt::WA_OpaquePaintEvent);
+        setAttribute(Qt::WA_TransparentForMouseEvents);
+    }
+
+    void setImage(const QPixmap& inImage) { mImage = inImage; }
+
+protected:
+    virtual void paintEvent(QPaintEvent* inEvent)
+    {
+        // Stretched without filtering, it is only on screen for a moment
+        QPainter painter(this);
+        painter.setClipRegion(inEvent->region());
+        painter.drawPixmap(rect(), mImage);
+    }
+
+private:
+    QPixmap mImage;
+};
+
+
 //=============================================================================
 // class WidgetAnimator
 //=============================================================================
 WidgetAnimator::WidgetAnimator(DynamicGridLayout* inLayout) 
-    :   mLayout(inLayout)
+    :   mMode(ModeGeometry)
+    ,   mLastTick(-1)
+    ,   mEasingCurve(QEasingCurve::InOutQuad)
+    ,   mLayout(inLayout)
+    ,   mPassDuration(-1)
 {
+    mMotions.reserve(kReservedMotions);
+    mFreeProxies.reserve(kReservedMotions);
+
+    mTimer.setInterval(kFrameInterval);
+    mTimer.setTimerType(Qt::PreciseTimer);
+    connect(&mTimer, SIGNAL(timeout()), SLOT(onTick()));
+
+    mClock.start();
 }
 
-void WidgetAnimator::abort(QWidget *w)
+
+WidgetAnimator::~WidgetAnimator()
 {
-    AnimationMap::iterator it = mAnimationMap.find(w);
-    if (it == mAnimationMap.end())
+    // Put back the widgets still moving. The proxies are children of the
+    // layout's widget, which deletes them.
+    for (int index = mMotions.count() - 1; index >= 0; --index)
+        removeMotion(index);
+}
+
+
+//-----------------------------------------------------------------------------
+// WidgetAnimator::setMode
+//
+/// Choose how widgets are animated. Widgets already moving finish in the
+/// mode they started in.
+/// \param inMode The mode.
+//-----------------------------------------------------------------------------
+void
+WidgetAnimator::setMode(Mode inMode)
+{
+    mMode = inMode;
+}
+
+
+//-----------------------------------------------------------------------------
+// WidgetAnimator::abort
+//
+/// Stop animating a widget, leaving it where it currently is.
+/// \param inWidget The widget.
+//-----------------------------------------------------------------------------
+void 
+WidgetAnimator::abort(QWidget* inWidget)
+{
+    const int index = findMotion(inWidget);
+    if (index == -1)
         return;
         
-    QPropertyAnimation *anim = *it;
-    mAnimationMap.erase(it);
-    anim->stop();
+    // A proxied widget comes back where its image was
+    const Motion& motion = mMotions.at(index);
+    if (motion.proxy != NULL)
+        inWidget->setGeometry(interpolate(motion, mClock.elapsed()));
+
+    removeMotion(index);
     //mLayout->animationFinished(w);
+
+    Q_EMIT animationStateChanged();
 }
 
 
-void 
-WidgetAnimator::animationFinished()
+//-----------------------------------------------------------------------------
+// WidgetAnimator::beginPass
+//
+/// Start a layout pass. The AnimationMonitor is asked once for the
+/// duration of all of the motions the pass starts or retargets, so they
+/// are degraded together rather than one widget at a time.
+/// \param inMovingCount The number of widgets that will be moving once
+/// the pass is done.
+/// \sa endPass
+//-----------------------------------------------------------------------------
+void
+WidgetAnimator::beginPass(int inMovingCount)
 {
-    QPropertyAnimation *anim = qobject_cast<QPropertyAnimation*>(sender());
-    abort(static_cast<QWidget*>(anim->targetObject()));
+    mPassDuration = AnimationMonitor::instance()->getDuration(kAnimationDuration, 
+                                                              mPolicy, 
+                                                              inMovingCount);
 }
 
 
-void 
-WidgetAnimator::animationObjectDestroyed()
+//-----------------------------------------------------------------------------
+// WidgetAnimator::endPass
+//
+/// End a layout pass started with beginPass().
+//-----------------------------------------------------------------------------
+void
+WidgetAnimator::endPass()
 {
-    QPropertyAnimation *anim = static_cast<QPropertyAnimation*>(sender());
-    Q_ASSERT(anim != NULL);
-    QWidget* animKeyWidget = mAnimationMap.key(anim);
-    mAnimationMap.remove(animKeyWidget);
-}  
+    mPassDuration = -1;
+}
 
 
+//-----------------------------------------------------------------------------
+// WidgetAnimator::animate
+//
+/// Move a widget to a destination. A widget that is already moving is
+/// retargeted from where it is now, in place. The AnimationMonitor may
+/// shorten the motion, or have the widget moved at once. Inside a layout
+/// pass the duration of the pass is used.
+/// \param inWidget The widget.
+/// \param inDestination The final geometry. An invalid rectangle sends
+/// the widget out of sight.
+/// \param inAnimate False to move the widget at once.
+//-----------------------------------------------------------------------------
 void
 WidgetAnimator::animate(QWidget* inWidget, const QRect& inDestination, bool inAnimate)
 {
@@ -85,38 +196,249 @@ WidgetAnimator::animate(QWidget* inWidget, const QRect& inDestination, bool inAn
     const QRect finalGeometry = inDestination.isValid() || inWidget->isWindow() ? inDestination :
         QRect(QPoint(-500 - inWidget->width(), -500 - inWidget->height()), inWidget->size());
 
+    const int index = findMotion(inWidget);
+
     // Check and see if we are already at the destination
-    if (widgetFrame == finalGeometry)
+    if (index == -1 && widgetFrame == finalGeometry)
         return;
         
-    AnimationMap::const_iterator it = mAnimationMap.constFind(inWidget);
-    if (it != mAnimationMap.constEnd() && NULL != (*it) 
-        && (*it)->endValue().toRect() == finalGeometry) {
+    if (index != -1 && mMotions.at(index).end == finalGeometry)
+        return;
+
+    // Degrade when frames are slow or too many widgets move together
+    int duration = 0;
+    if (inAnimate) {
+        if (mPassDuration != -1) {
+            duration = mPassDuration;
+        } else {
+            const int movingCount = mMotions.count() + (index == -1 ? 1 : 0);
+            duration = AnimationMonitor::instance()->getDuration(kAnimationDuration, mPolicy, movingCount);
+        }
+        inAnimate = duration > 0;
+    }
+
+    if (!inAnimate) {
+        if (index != -1)
+            removeMotion(index);
+        inWidget->setGeometry(finalGeometry);
+
+        if (index != -1)
+            Q_EMIT animationStateChanged();
+        return;
+    }
+
+    const qint64 now = mClock.elapsed();
+
+    if (index != -1) {
+        // Retarget from the current position
+        Motion& motion = mMotions[index];
+        motion.start = interpolate(motion, now);
+        motion.end = finalGeometry;
+        motion.startTime = now;
+        motion.duration = duration;
+    } else {
+        Motion motion;
+        motion.widget = inWidget;
+        motion.proxy = NULL;
+        motion.hidden = false;
+        motion.start = widgetFrame;
+        motion.end = finalGeometry;
+        motion.startTime = now;
+        motion.duration = duration;
+        if (mMode == ModeProxy && mLayout->parentWidget() != NULL && !inWidget->isWindow()) {
+            motion.proxy = acquireProxy(inWidget, widgetFrame);
+
+            // The image stands in for the widget, which keeps its geometry.
+            // Hiding it takes the focus away, so remember where it was.
+            QWidget* theFocus = QApplication::focusWidget();
+            if (theFocus != NULL && inWidget->isAncestorOf(theFocus))
+                motion.focus = theFocus;
+            motion.hidden = !inWidget->isHidden();
+            inWidget->hide();
+        }
+
+        mMotions.append(motion);
+        connect(inWidget, SIGNAL(destroyed(QObject*)), SLOT(onWidgetDestroyed(QObject*)));
+    }
+
+    if (!mTimer.isActive()) {
+        mLastTick = -1;
+        mTimer.start();
+    }
+
+    Q_EMIT animationStateChanged();
+}
+
+
+//-----------------------------------------------------------------------------
+// WidgetAnimator::onTick    [slot]
+//
+/// Advance every moving widget by one frame. The geometries are all set
+/// in the same pass of the event loop, so Qt repaints the frame once. A
+/// tick late because the last frame was slow to paint shows in the time
+/// reported to the AnimationMonitor.
+//-----------------------------------------------------------------------------
+void 
+WidgetAnimator::onTick()
+{
+    if (mMotions.isEmpty()) {
+        mTimer.stop();
         return;
     }
 
-    // Set up the property animation    
-    QPropertyAnimation* theAnimation = new QPropertyAnimation(inWidget, "geometry", inWidget);
-    theAnimation->setDuration(inAnimate ? kAnimationDuration : 0);
-    theAnimation->setEasingCurve(QEasingCurve::InOutQuad);
-    theAnimation->setStartValue(widgetFrame);
-    theAnimation->setEndValue(finalGeometry);
-    mAnimationMap[inWidget] = theAnimation;
-    connect(theAnimation, SIGNAL(finished()), SLOT(animationFinished()));
-    connect(theAnimation, SIGNAL(destroyed()), SLOT(animationObjectDestroyed()));
-    theAnimation->start(QPropertyAnimation::DeleteWhenStopped);
+    const qint64 now = mClock.elapsed();
+    if (mLastTick != -1)
+        AnimationMonitor::instance()->reportFrame(now - mLastTick);
+    mLastTick = now;
+
+    bool finished = false;
+    for (int index = mMotions.count() - 1; index >= 0; --index) {
+        const Motion& motion = mMotions.at(index);
+        QWidget* theWidget = motion.proxy != NULL ? motion.proxy : motion.widget;
+        if (now - motion.startTime >= motion.duration) {
+            // The real widget gets its geometry exactly once
+            motion.widget->setGeometry(motion.end);
+            removeMotion(index);
+            finished = true;
+        } else {
+            theWidget->setGeometry(interpolate(motion, now));
+        }
+    }
+
+    if (mMotions.isEmpty())
+        mTimer.stop();
+
+    if (finished)
+        Q_EMIT animationStateChanged();
 }
 
 
-bool 
-WidgetAnimator::animating() const
+//-----------------------------------------------------------------------------
+// WidgetAnimator::onWidgetDestroyed    [slot]
+//-----------------------------------------------------------------------------
+void 
+WidgetAnimator::onWidgetDestroyed(QObject* inWidget)
 {
-    return !mAnimationMap.isEmpty();
+    const int index = findMotion(static_cast<QWidget*>(inWidget));
+    if (index == -1)
+        return;
+
+    if (mMotions.at(index).proxy != NULL)
+        releaseProxy(mMotions.at(index).proxy);
+    mMotions.remove(index);
+}  
+
+
+//-----------------------------------------------------------------------------
+// WidgetAnimator::findMotion
+//
+/// \result The index of the motion of a widget, or -1.
+//-----------------------------------------------------------------------------
+int
+WidgetAnimator::findMotion(QWidget* inWidget) const
+{
+    for (int index = 0; index < mMotions.count(); ++index) {
+        if (mMotions.at(index).widget == inWidget)
+            return index;
+    }
+
+    return -1;
 }
 
 
-bool 
-WidgetAnimator::animating(QWidget* inWidget) const
+//-----------------------------------------------------------------------------
+// WidgetAnimator::removeMotion
+//
+/// Remove a motion, showing a proxied widget again. The last motion takes
+/// its slot, so nothing else is moved or allocated.
+//-----------------------------------------------------------------------------
+void
+WidgetAnimator::removeMotion(int inIndex)
 {
-    return mAnimationMap.contains(inWidget);
+    // Taken out first, showing the widget sends it events right away
+    const Motion motion = mMotions.at(inIndex);
+    if (inIndex != mMotions.count() - 1)
+        mMotions[inIndex] = mMotions.last();
+    mMotions.removeLast();
+
+    disconnect(motion.widget, SIGNAL(destroyed(QObject*)), 
+               this, SLOT(onWidgetDestroyed(QObject*)));
+
+    if (motion.proxy != NULL) {
+        // Show the widget before its image goes, in the same frame
+        if (motion.hidden)
+            motion.widget->show();
+        if (!motion.focus.isNull())
+            motion.focus->setFocus();
+        releaseProxy(motion.proxy);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// WidgetAnimator::acquireProxy
+//
+/// Capture a widget into a proxy placed over it. Proxies are reused.
+/// \param inWidget The widget starting to move.
+/// \param inGeometry Its current geometry.
+/// \result The proxy, shown just above the widget.
+//-----------------------------------------------------------------------------
+WidgetProxy*
+WidgetAnimator::acquireProxy(QWidget* inWidget, const QRect& inGeometry)
+{
+    WidgetProxy* theProxy = NULL;
+    if (!mFreeProxies.isEmpty()) {
+        theProxy = mFreeProxies.last();
+        mFreeProxies.removeLast();
+    } else {
+        theProxy = new WidgetProxy(mLayout->parentWidget());
+    }
+
+    theProxy->setImage(inWidget->grab());
+    theProxy->setGeometry(inGeometry);
+    theProxy->show();
+
+    // Directly above the widget, so whatever covered it still covers it
+    if (inWidget->parentWidget() == theProxy->parentWidget()) {
+        theProxy->stackUnder(inWidget);
+        inWidget->stackUnder(theProxy);
+    } else {
+        theProxy->raise();
+    }
+
+    return theProxy;
+}
+
+
+//-----------------------------------------------------------------------------
+// WidgetAnimator::releaseProxy
+//-----------------------------------------------------------------------------
+void
+WidgetAnimator::releaseProxy(WidgetProxy* inProxy)
+{
+    inProxy->hide();
+    inProxy->setImage(QPixmap());
+    mFreeProxies.append(inProxy);
+}
+
+
+//-----------------------------------------------------------------------------
+// WidgetAnimator::interpolate
+//
+/// \result The geometry of a moving widget at a given time.
+//-----------------------------------------------------------------------------
+QRect
+WidgetAnimator::interpolate(const Motion& inMotion, qint64 inNow) const
+{
+    const qreal progress = qBound(qreal(0), 
+                                  qreal(inNow - inMotion.startTime) / inMotion.duration, 
+                                  qreal(1));
+    const qreal value = mEasingCurve.valueForProgress(progress);
+
+    const QRect& from = inMotion.start;
+    const QRect& to = inMotion.end;
+    return QRect(from.x() + qRound((to.x() - from.x()) * value),
+                 from.y() + qRound((to.y() - from.y()) * value),
+                 from.width() + qRound((to.width() - from.width()) * value),
+                 from.height() + qRound((to.height() - from.height()) * value));
 }
@@ -22,39 +22,112 @@ THE SOFTWARE.
 #define WIDGETANIMATOR_HAS_BEEN_INCLUDED
 
 // Qt
-#include <QMap>
+#include <QEasingCurve>
+#include <QElapsedTimer>
 #include <QObject>
+#include <QPointer>
+#include <QRect>
+#include <QTimer>
+#include <QVector>
+
+// Local
+#include "AnimationMonitor.h"
 
 // Forward declarations
 class DynamicGridLayout;
-class QPropertyAnimation;
-class QRect;
 class QWidget;
+class WidgetProxy;
 
 //=============================================================================
 // class WidgetAnimator
 //=============================================================================
+/// \brief Animates the geometry of the widgets of a layout.
+///
+/// A single timer drives every moving widget. Each tick interpolates all
+/// of them and commits the new geometries together, so the whole frame
+/// is painted once.
+///
+/// In proxy mode a widget is captured once when it starts moving, and an
+/// image of it is animated instead. The widget itself is hidden and gets
+/// its final geometry, and so lays out its contents, only once at the end.
+///
+/// The time between ticks is reported to the AnimationMonitor, which
+/// shortens or skips new motions under the animator's policy. A layout
+/// pass brackets its calls with beginPass() and endPass(), so the
+/// duration is decided once and every widget of the pass moves alike.
+///
 class WidgetAnimator : public QObject
 {
     Q_OBJECT
     
 public:
+    enum Mode {
+        ModeGeometry,   ///< Resize the real widgets on every frame
+        ModeProxy       ///< Move captured images, resize the widgets once
+    };
+
     WidgetAnimator(DynamicGridLayout* inLayout);
+    ~WidgetAnimator();
+
+    Mode getMode() const;
+    void setMode(Mode inMode);
+
+    const AnimationMonitor::Policy& getPolicy() const;
+    void setPolicy(const AnimationMonitor::Policy& inPolicy);
+
+    void beginPass(int inMovingCount);
+    void endPass();
+
     void animate(QWidget* inWidget, const QRect& inDestination, bool animate);
     bool animating() const;
     bool animating(QWidget* inWidget) const;
 
     void abort(QWidget* inWidget);
 
+Q_SIGNALS:
+    void animationStateChanged();
+
 private Q_SLOTS:
-    void animationFinished();
-    void animationObjectDestroyed();
+    void onTick();
+    void onWidgetDestroyed(QObject* inWidget);
 
 private:
-    typedef QMap<QWidget*, QPropertyAnimation*> AnimationMap;
-    AnimationMap mAnimationMap;
+    Q_DISABLE_COPY(WidgetAnimator)
+
+    // One widget on its way to a destination
+    struct Motion {
+        QWidget* widget;
+        WidgetProxy* proxy;
+        bool hidden;                // Hidden behind the proxy, to show again
+        QPointer<QWidget> focus;    // Had the focus when it was hidden
+        QRect start;
+        QRect end;
+        qint64 startTime;
+        int duration;
+    };
+
+    int findMotion(QWidget* inWidget) const;
+    void removeMotion(int inIndex);
+    WidgetProxy* acquireProxy(QWidget* inWidget, const QRect& inGeometry);
+    void releaseProxy(WidgetProxy* inProxy);
+    QRect interpolate(const Motion& inMotion, qint64 inNow) const;
+
+    QVector<Motion> mMotions;
+    QVector<WidgetProxy*> mFreeProxies;
+    Mode mMode;
+    AnimationMonitor::Policy mPolicy;
+    QTimer mTimer;
+    QElapsedTimer mClock;
+    qint64 mLastTick;
+    QEasingCurve mEasingCurve;
     DynamicGridLayout* mLayout;
+    int mPassDuration;              // -1 outside of a layout pass
 };
 
-#endif // !WIDGETANIMATOR_HAS_BEEN_INCLUDED
+inline WidgetAnimator::Mode WidgetAnimator::getMode() const { return mMode; }
+inline const AnimationMonitor::Policy& WidgetAnimator::getPolicy() const { return mPolicy; }
+inline void WidgetAnimator::setPolicy(const AnimationMonitor::Policy& inPolicy) { mPolicy = inPolicy; }
+inline bool WidgetAnimator::animating() const { return !mMotions.isEmpty(); }
+inline bool WidgetAnimator::animating(QWidget* inWidget) const { return findMotion(inWidget) != -1; }
 
+#endif // !WIDGETANIMATOR_HAS_BEEN_INCLUDED
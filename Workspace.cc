@@ -33,16 +33,20 @@ THE SOFTWARE.
 #include <QDragEnterEvent>
 #include <QEvent>
 #include <QFile>
+#include <QIcon>
 #include <QLayout>
 #include <QMainWindow>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMimeData>
+#include <QSet>
 #include <QSettings>
 #include <QSignalMapper>
 #include <QStyleOptionDockWidget>
 #include <QStylePainter>
 #include <QtAlgorithms>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include <QTimer>
 #include <QToolBar>
 #include <QtDebug>
@@ -51,7 +55,13 @@ THE SOFTWARE.
 #include <QXmlStreamWriter>
 
 // Local
+#include "EmbeddedLayout.h"
+#include "LayoutLibrary.h"
+#include "PluginCatalog.h"
+#include "TaskScheduler.h"
+#include "UpdateScheduler.h"
 #include "WorkspaceItem.h"
+#include "WorkspaceLayout.h"
 #include "WorkspacePanel.h"
 
 // Namespaces
@@ -95,9 +105,77 @@ bool SavedLayout::operator==(const SavedLayout& other) const
     return name == other.name;
 }
 
+//=============================================================================
+// struct ParsedState
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// ParsedState::ParsedState()
+//
+/// Construct an empty parse result
+//-----------------------------------------------------------------------------
+ParsedState::ParsedState()
+        :   attempted(false),
+            restored(false)
+{
+}
+
+//=============================================================================
+// struct SolvedLayout
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// SolvedLayout::SolvedLayout()
+//
+/// Construct an unsolved layout
+//-----------------------------------------------------------------------------
+SolvedLayout::SolvedLayout()
+        :   generation(0)
+{
+}
+
+//=============================================================================
+// struct HibernationStats
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// HibernationStats::HibernationStats()
+//-----------------------------------------------------------------------------
+HibernationStats::HibernationStats()
+        :   hibernatedPanels(0),
+            viewStateBytes(0),
+            widgetTreeBytes(0),
+            hibernations(0),
+            recreations(0),
+            totalRecreateTime(0),
+            maxRecreateTime(0)
+{
+}
+
+//=============================================================================
+// class PanelFactory
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// PanelFactory::~PanelFactory()
+//-----------------------------------------------------------------------------
+PanelFactory::~PanelFactory()
+{
+}
+
 //=============================================================================
 // class Workspace
 //=============================================================================
+static const int kSolveLayoutsDelay = 250;
+static const int kHibernateCheckInterval = 30 * 1000;
+
+// Separates the base name of a panel from its instance number
+static const QChar kPanelInstanceSeparator('#');
+
+// Rough heap cost of a widget and of any other object, private data included
+static const qint64 kWidgetBytesEstimate = 1024;
+static const qint64 kObjectBytesEstimate = 128;
+static const int kSaveStateDelay = 2000;
 
 //-----------------------------------------------------------------------------
 // Workspace::Workspace()
@@ -118,13 +196,24 @@ Workspace::Workspace(const QString& inTitle)
         mPanelsMenu(NULL),
         mTitle(inTitle),
         mMainWindow(NULL),
-        mSaveStateTimer(NULL),
+        mDefaultLayout(NULL),
+        mSaveStateTaskId(-1),
+        mStateWatcher(NULL),
+        mStatePending(false),
+        mStateRestored(false),
         mPanelContentsMarginLeft(0),
         mPanelContentsMarginTop(0),
         mPanelContentsMarginRight(0),
         mPanelContentsMarginBottom(0),
         mPanelContentsMarginsSet(false),
-        mLayoutDeferrals(0)
+        mLayoutDeferrals(0),
+        mLayoutLibrary(NULL),
+        mSolveTimer(NULL),
+        mSolveWatcher(NULL),
+        mHibernateTaskId(-1),
+        mHibernationTimeout(0),
+        mUpdateScheduler(NULL),
+        mPluginCatalog(NULL)
 
 {
     // Create the main menu bar
@@ -133,7 +222,22 @@ Workspace::Workspace(const QString& inTitle)
     mWindowMapper = new QSignalMapper(this);
     connect(mWindowMapper, SIGNAL(mapped(QWidget *)), this, SLOT(setActiveSubWindow(QWidget *)));
 
-    mSaveStateTimer = new QTimer(this);
+    mLayoutLibrary = new LayoutLibrary();
+
+    mPluginCatalog = new PluginCatalog(this);
+
+    mStateWatcher = new QFutureWatcher<ParsedState>(this);
+    connect(mStateWatcher, SIGNAL(finished()), this, SLOT(onStateParsed()));
+
+    // Saved layouts are solved again once things have settled down
+    mSolveTimer = new QTimer(this);
+    mSolveTimer->setSingleShot(true);
+    mSolveTimer->setInterval(kSolveLayoutsDelay);
+    connect(mSolveTimer, SIGNAL(timeout()), this, SLOT(onSolveLayouts()));
+
+    mSolveWatcher = new QFutureWatcher<SolvedLayout>(this);
+    connect(mSolveWatcher, SIGNAL(finished()), this, SLOT(onLayoutsSolved()));
+
 }
 
 
@@ -142,6 +246,10 @@ Workspace::Workspace(const QString& inTitle)
 //-----------------------------------------------------------------------------
 Workspace::~Workspace()
 {
+    // Don't leave a parse or solve running against a destroyed workspace
+    mStateWatcher->waitForFinished();
+    mSolveWatcher->waitForFinished();
+
     if (mMainWindow != NULL) {
         // Set mMainWindow to NULL before deleting it to prevent stale pointer
         // derefs in event filter
@@ -149,6 +257,9 @@ Workspace::~Workspace()
         mMainWindow = NULL;
         delete mw;
     }
+
+    delete mLayoutLibrary;
+    delete mPluginCatalog;
 }
 
 
@@ -213,8 +324,6 @@ Workspace::initialize()
     initMenus();
 
     initializeDockInfo();
-    
-    connect(mSaveStateTimer, SIGNAL(timeout()), this, SLOT(saveState()));
 }
 
 void
@@ -251,6 +360,10 @@ Workspace::initializeDockInfo()
 
     // Set the central widget of the main window
     mMainWindow->setCentralWidget(workspaceArea);
+    workspaceArea->setAnimationPolicy(mAnimationPolicy);
+
+    // Panels share one update budget instead of running their own timers
+    mUpdateScheduler = new UpdateScheduler(workspaceArea, this);
 
     // Display the status bar
     (void) mMainWindow->statusBar();
@@ -274,8 +387,17 @@ Workspace::initializeDockInfo()
 void
 Workspace::startSaveStateTimer()
 {
-    if (mLayoutDeferrals == 0)
-        mSaveStateTimer->start(2000);
+    if (mLayoutDeferrals != 0)
+        return;
+
+    // Restart the delay, so a burst of changes is saved once. The save
+    // must not wait until the user comes back to the application.
+    TaskScheduler* theScheduler = TaskScheduler::instance();
+    theScheduler->cancel(mSaveStateTaskId);
+    mSaveStateTaskId = theScheduler->schedule(this, 
+                                              SLOT(saveState()), 
+                                              kSaveStateDelay, 
+                                              TaskScheduler::RunWhenInactive);
 }
 
 //-----------------------------------------------------------------------------
@@ -313,6 +435,7 @@ Workspace::eventFilter(QObject* inObject, QEvent* inEvent)
             break;
 
         case QEvent::Resize :
+            invalidateSolvedLayouts();
             startSaveStateTimer();
             break;
             
@@ -323,9 +446,27 @@ Workspace::eventFilter(QObject* inObject, QEvent* inEvent)
         if (inEvent->type() == QEvent::Move)
             startSaveStateTimer();
 
+        // Let the CPU sleep while the workspace is minimized
+        if (inEvent->type() == QEvent::WindowStateChange)
+            TaskScheduler::instance()->setPaused(mMainWindow->isMinimized());
+
     } else {
         // Not the central widget, probably a panel.
         switch (inEvent->type()){
+        case QEvent::Show   :
+            // Build the content of a placeholder the first time it is seen
+            assert(qobject_cast<WorkspacePanel*>(inObject) != NULL);
+            mHiddenSince.remove(inObject->objectName());
+            if (isPlaceholderPanel(static_cast<WorkspacePanel*>(inObject)))
+                materializePanel(static_cast<WorkspacePanel*>(inObject));
+            break;
+
+        case QEvent::Hide   :
+            // Remember how long the panel has been out of sight
+            if (mHibernationTimeout > 0)
+                mHiddenSince[inObject->objectName()].start();
+            break;
+
         case QEvent::Move   :
         case QEvent::Resize :
         case QEvent::Close  :
@@ -361,12 +502,6 @@ Workspace::addWidget(QWidget* inWidget,
     Q_ASSERT(inWidget != NULL);
     Q_ASSERT(mMainWindow != NULL);
 
-    // Reparent this widget to ourself
-    inWidget->setParent(mMainWindow);
-    
-    // So we can draw the background between panels
-    inWidget->setAutoFillBackground(true);
-
     WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
     Q_ASSERT(workspaceArea != NULL);
 
@@ -374,13 +509,45 @@ Workspace::addWidget(QWidget* inWidget,
     panel->installEventFilter(this);
  
     panel->setObjectName(inName);
-    panel->setWidget(inWidget);
+    initPanelWidget(panel, inWidget);
+    
+    if (isFloating) {
+        workspaceArea->addFloatingPanel(panel);
+    } else {
+        if (inGroup == NULL) {
+            workspaceArea->addPanel(panel, Qt::Horizontal);
+        } else {
+            WorkspacePanel* theGroup = qobject_cast<WorkspacePanel*>(inGroup);
+            Q_ASSERT(theGroup != NULL);
+            workspaceArea->addToPanelGroup(theGroup, panel);           
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::initPanelWidget()
+//
+/// Make the widget the content of the panel.
+/// \param inPanel The panel.
+/// \param inWidget The content widget.
+//-----------------------------------------------------------------------------
+void
+Workspace::initPanelWidget(WorkspacePanel* inPanel, QWidget* inWidget)
+{
+    // Reparent this widget to ourself
+    inWidget->setParent(mMainWindow);
+    
+    // So we can draw the background between panels
+    inWidget->setAutoFillBackground(true);
+
+    inPanel->setWidget(inWidget);
 
     // If the inWidget is a WorkspaceItem, then let it keep a pointer 
     // to its owning panel
     WorkspaceItem* wbItem = qobject_cast<WorkspaceItem*>(inWidget);
     if (NULL != wbItem) {
-        wbItem->setOwningPanel(panel);
+        wbItem->setOwningPanel(inPanel);
     }
 
     if (mPanelContentsMarginsSet && inWidget->layout() != NULL) {
@@ -390,18 +557,456 @@ Workspace::addWidget(QWidget* inWidget,
             mPanelContentsMarginRight,
             mPanelContentsMarginBottom);
     }
-    
-    if (isFloating) {
-        workspaceArea->addFloatingPanel(panel);
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::registerPanelFactory()
+//
+/// Register the factory that creates the content of the named panel.
+/// Panels with a factory are restored as placeholders and only built when
+/// they are first shown. The factory also serves numbered instances of
+/// the name, such as "Histogram#2". The workspace does not take ownership
+/// of the factory.
+/// \param inName The object name of the panel.
+/// \param inFactory The factory.
+//-----------------------------------------------------------------------------
+void
+Workspace::registerPanelFactory(const QString& inName, PanelFactory* inFactory)
+{
+    Q_ASSERT(inFactory != NULL);
+    mPanelFactories[inName] = inFactory;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::unregisterPanelFactory()
+//
+/// Remove the factory of the named panel. Placeholders for the panel stay
+/// empty.
+/// \param inName The object name of the panel.
+//-----------------------------------------------------------------------------
+void
+Workspace::unregisterPanelFactory(const QString& inName)
+{
+    mPanelFactories.remove(inName);
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::addPlaceholderPanel()
+//
+/// Add an empty panel whose content is created by the registered factory
+/// the first time the panel is shown. Until then the panel is only a tab.
+/// \param inName The object name of the panel.
+/// \param inGroup The panel group to add the panel to, or NULL.
+/// \param inTitle The tab title. Defaults to the name.
+/// \result The placeholder panel.
+//-----------------------------------------------------------------------------
+WorkspacePanel*
+Workspace::addPlaceholderPanel(const QString& inName,
+                               QWidget* inGroup,
+                               const QString& inTitle)
+{
+    Q_ASSERT(mMainWindow != NULL);
+    Q_ASSERT(findPanelFactory(inName) != NULL);
+
+    WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
+    Q_ASSERT(workspaceArea != NULL);
+
+    WorkspacePanel* panel = new WorkspacePanel(inTitle.isEmpty() ? inName : inTitle, workspaceArea);
+    panel->installEventFilter(this);
+    panel->setObjectName(inName);
+
+    if (inGroup == NULL) {
+        workspaceArea->addPanel(panel, Qt::Horizontal);
     } else {
-        if (inGroup == NULL) {
-            workspaceArea->addPanel(panel, Qt::Horizontal);
-        } else {
-            WorkspacePanel* theGroup = qobject_cast<WorkspacePanel*>(inGroup);
-            Q_ASSERT(theGroup != NULL);
-            workspaceArea->addToPanelGroup(theGroup, panel);           
+        WorkspacePanel* theGroup = qobject_cast<WorkspacePanel*>(inGroup);
+        Q_ASSERT(theGroup != NULL);
+        workspaceArea->addToPanelGroup(theGroup, panel);           
+    }
+
+    return panel;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::isPlaceholderPanel()
+//
+/// \param inPanel The panel.
+/// \result True if the panel has no content yet but a factory to create it.
+//-----------------------------------------------------------------------------
+bool
+Workspace::isPlaceholderPanel(WorkspacePanel* inPanel) const
+{
+    return inPanel != NULL 
+        && inPanel->widget() == NULL 
+        && findPanelFactory(inPanel->objectName()) != NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::findPanelFactory()
+//
+/// Find the factory for a panel. A factory registered for a name also
+/// creates the content of the numbered instances of that name.
+/// \param inName The object name of the panel.
+/// \result The factory, or NULL if there is none.
+/// \sa getUniquePanelName
+//-----------------------------------------------------------------------------
+PanelFactory*
+Workspace::findPanelFactory(const QString& inName) const
+{
+    PanelFactory* theFactory = mPanelFactories.value(inName);
+    if (theFactory == NULL)
+        theFactory = mPanelFactories.value(getPanelBaseName(inName));
+
+    return theFactory;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::getUniquePanelName()
+//
+/// Get an object name for a new panel that no open panel uses yet. The
+/// first panel gets the base name, later ones are numbered as in
+/// "Histogram#2".
+/// \param inBaseName The base name, typically a class name.
+/// \result The unique name.
+//-----------------------------------------------------------------------------
+QString
+Workspace::getUniquePanelName(const QString& inBaseName) const
+{
+    Q_ASSERT(mMainWindow != NULL);
+
+    QSet<QString> theNames;
+    Q_FOREACH(WorkspacePanel* thePanel, mMainWindow->findChildren<WorkspacePanel*>())
+        theNames.insert(thePanel->objectName());
+
+    QString theName = inBaseName;
+    for (int index = 2; theNames.contains(theName); ++index)
+        theName = QString("%1%2%3").arg(inBaseName).arg(kPanelInstanceSeparator).arg(index);
+
+    return theName;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::getPanelBaseName()
+//
+/// Strip the instance number that getUniquePanelName() may have added.
+/// \param inName The object name of a panel.
+/// \result The base name.
+//-----------------------------------------------------------------------------
+QString
+Workspace::getPanelBaseName(const QString& inName)
+{
+    const int theSeparator = inName.lastIndexOf(kPanelInstanceSeparator);
+    if (theSeparator <= 0)
+        return inName;
+
+    bool isNumber = false;
+    inName.mid(theSeparator + 1).toInt(&isNumber);
+
+    return isNumber ? inName.left(theSeparator) : inName;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::materializePanel()
+//
+/// Create the content of a placeholder panel with its registered factory.
+/// This is done automatically when the panel is first shown.
+/// \param inPanel The placeholder panel.
+/// \result True if content was created.
+//-----------------------------------------------------------------------------
+bool
+Workspace::materializePanel(WorkspacePanel* inPanel)
+{
+    if (!isPlaceholderPanel(inPanel))
+        return false;
+
+    const QString theName = inPanel->objectName();
+    const bool hibernated = mViewStates.contains(theName);
+
+    QElapsedTimer theTimer;
+    theTimer.start();
+
+    QWidget* theWidget = findPanelFactory(theName)->createPanelWidget(theName);
+    if (theWidget == NULL)
+        return false;
+
+    initPanelWidget(inPanel, theWidget);
+
+    WorkspaceItem* theItem = qobject_cast<WorkspaceItem*>(theWidget);
+    if (theItem != NULL && !mWorkspaceItems.contains(theItem)) {
+        mWorkspaceItems.append(theItem);
+        mergeMenus(theItem);
+        theItem->startPreparation();
+    }
+
+    if (hibernated) {
+        const QByteArray theState = mViewStates.take(theName);
+        mWidgetTreeBytes.remove(theName);
+        if (theItem != NULL)
+            theItem->restoreViewState(theState);
+
+        const qint64 elapsed = theTimer.elapsed();
+        ++mHibernationStats.recreations;
+        mHibernationStats.totalRecreateTime += elapsed;
+        mHibernationStats.maxRecreateTime = qMax(mHibernationStats.maxRecreateTime, elapsed);
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::setHibernationTimeout()
+//
+/// Set how long a panel may stay hidden, typically in a background tab,
+/// before its content is destroyed to free memory. Only panels with a
+/// registered panel factory are hibernated. A WorkspaceItem is asked for
+/// its view state first, and the content is created again transparently
+/// the next time the panel is shown.
+/// \param inMinutes The timeout in minutes. Zero disables hibernation.
+/// \sa WorkspaceItem::saveViewState
+//-----------------------------------------------------------------------------
+void
+Workspace::setHibernationTimeout(int inMinutes)
+{
+    mHibernationTimeout = qMax(0, inMinutes);
+    mHiddenSince.clear();
+
+    TaskScheduler::instance()->cancel(mHibernateTaskId);
+    mHibernateTaskId = -1;
+
+    if (mHibernationTimeout == 0)
+        return;
+
+    // Start the clock for the panels that are already hidden
+    if (mMainWindow != NULL) {
+        WorkspacePanelList thePanels;
+        getOpenPanelsList(thePanels);
+        Q_FOREACH(WorkspacePanel* thePanel, thePanels) {
+            if (!thePanel->isVisible())
+                mHiddenSince[thePanel->objectName()].start();
         }
     }
+
+    mHibernateTaskId = TaskScheduler::instance()->schedule(this, 
+                                                           SLOT(onHibernatePanels()), 
+                                                           kHibernateCheckInterval,
+                                                           TaskScheduler::Repeat);
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::hibernatePanel()
+//
+/// Destroy the content of a hidden panel, keeping the view state of a
+/// WorkspaceItem. The panel turns back into a placeholder. An item that
+/// is still preparing is left alone, it has no view state to keep yet.
+/// \param inPanel The panel.
+/// \result True if the panel was hibernated.
+//-----------------------------------------------------------------------------
+bool
+Workspace::hibernatePanel(WorkspacePanel* inPanel)
+{
+    if (inPanel == NULL || inPanel->isVisible() || inPanel->isFloating())
+        return false;
+
+    const QString theName = inPanel->objectName();
+    QWidget* theWidget = inPanel->widget();
+    if (theWidget == NULL || findPanelFactory(theName) == NULL)
+        return false;
+
+    WorkspaceItem* theItem = qobject_cast<WorkspaceItem*>(theWidget);
+    if (theItem != NULL && theItem->isPreparing())
+        return false;
+
+    QByteArray theState;
+    if (theItem != NULL) {
+        theState = theItem->saveViewState();
+        unmergeMenus(theItem);
+        mWorkspaceItems.removeAll(theItem);
+    }
+
+    mWidgetTreeBytes[theName] = estimateWidgetTreeBytes(theWidget);
+
+    inPanel->setWidget(NULL);
+    theWidget->deleteLater();
+
+    mViewStates[theName] = theState;
+    mHiddenSince.remove(theName);
+    ++mHibernationStats.hibernations;
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::getHibernationStats()
+//
+/// \result The hibernation counters.
+//-----------------------------------------------------------------------------
+HibernationStats
+Workspace::getHibernationStats() const
+{
+    HibernationStats theStats = mHibernationStats;
+    theStats.hibernatedPanels = mViewStates.size();
+
+    Q_FOREACH(const QByteArray& theState, mViewStates)
+        theStats.viewStateBytes += theState.size();
+
+    Q_FOREACH(qint64 theBytes, mWidgetTreeBytes)
+        theStats.widgetTreeBytes += theBytes;
+
+    return theStats;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::estimateWidgetTreeBytes()
+//
+/// Estimate the memory held by a widget and everything below it. Each
+/// widget and object is charged a fixed cost, and each native child widget
+/// is charged for the pixels of its own surface.
+/// \param inWidget The root of the tree.
+/// \result The estimated size in bytes.
+//-----------------------------------------------------------------------------
+qint64
+Workspace::estimateWidgetTreeBytes(QWidget* inWidget)
+{
+    qint64 theBytes = 0;
+
+    QList<QObject*> theObjects = inWidget->findChildren<QObject*>();
+    theObjects.prepend(inWidget);
+
+    Q_FOREACH(QObject* theObject, theObjects) {
+        QWidget* theWidget = qobject_cast<QWidget*>(theObject);
+        if (theWidget == NULL) {
+            theBytes += kObjectBytesEstimate;
+            continue;
+        }
+
+        theBytes += kWidgetBytesEstimate;
+
+        // Native children keep a backing surface of their own
+        if (theWidget->internalWinId() != 0 && theWidget != theWidget->window())
+            theBytes += qint64(theWidget->width()) * theWidget->height() * ((theWidget->depth() + 7) / 8);
+    }
+
+    return theBytes;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::setAnimationPolicy()
+//
+/// Set how this workspace shortens or skips its layout animations when
+/// frames take longer than the policy's budget, or when many panel groups
+/// move at once. A performance mode set on the AnimationMonitor for the
+/// whole application takes precedence.
+/// \param inPolicy The policy.
+/// \sa AnimationMonitor::setPerformanceMode
+//-----------------------------------------------------------------------------
+void
+Workspace::setAnimationPolicy(const AnimationMonitor::Policy& inPolicy)
+{
+    mAnimationPolicy = inPolicy;
+
+    if (mMainWindow == NULL)
+        return;
+
+    WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
+    if (workspaceArea != NULL)
+        workspaceArea->setAnimationPolicy(inPolicy);
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::onHibernatePanels()  [slot]
+//
+/// Hibernate the panels that have been hidden for longer than the
+/// hibernation timeout.
+//-----------------------------------------------------------------------------
+void
+Workspace::onHibernatePanels()
+{
+    if (mMainWindow == NULL || mHibernationTimeout == 0)
+        return;
+
+    WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
+    Q_ASSERT(workspaceArea != NULL);
+
+    const qint64 timeout = qint64(mHibernationTimeout) * 60 * 1000;
+
+    QMutableMapIterator<QString, QElapsedTimer> iter(mHiddenSince);
+    while (iter.hasNext()) {
+        iter.next();
+        if (iter.value().elapsed() < timeout)
+            continue;
+
+        WorkspacePanel* thePanel = workspaceArea->findPanel(iter.key());
+        iter.remove();
+
+        if (thePanel != NULL)
+            hibernatePanel(thePanel);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::mergeMenus()
+//
+/// Merge the menus of the item as requested by its merge type.
+/// \param inItem The item.
+//-----------------------------------------------------------------------------
+void
+Workspace::mergeMenus(WorkspaceItem* inItem)
+{
+    switch (inItem->getMenuMergeType()) {
+        case WorkspaceItem::ADD:
+            addItemMenus(inItem);
+            break;
+
+        case WorkspaceItem::MERGE:
+            mergeItemMenus(inItem);
+            break;
+
+        case WorkspaceItem::REMOVE:
+            removeItemMenus(inItem);
+            break;
+
+        case WorkspaceItem::REPLACE:
+            replaceItemMenus(inItem);
+            break;
+
+        case WorkspaceItem::NONE:
+        default:
+            // No menus to merge
+            break;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::unmergeMenus()
+//
+/// Take the menus of the item out of the menu bar again, typically because
+/// the item is about to be destroyed. Undoes mergeMenus().
+/// \param inItem The item.
+//-----------------------------------------------------------------------------
+void
+Workspace::unmergeMenus(WorkspaceItem* inItem)
+{
+    if (inItem->getMenuMergeType() != WorkspaceItem::ADD)
+        return;
+
+    const WorkspaceItem::MenuList& menuList = inItem->getMenuList();
+    Q_FOREACH(QMenu* menu, menuList)
+        mMenuBar->removeAction(menu->menuAction());
 }
 
 
@@ -420,14 +1025,15 @@ Workspace::beginDeferLayout()
 
 /// When restoring open widgets and workspaceitems, you don't want the layout
 /// adjusted until all the widgets have been added. Call this after adding
-/// widgets or workspaceitems.
+/// widgets or workspaceitems. If inAnimate is true, panels animate into
+/// their final positions.
 void
-Workspace::endDeferLayout()
+Workspace::endDeferLayout(bool inAnimate)
 {
     if (--mLayoutDeferrals == 0){
         WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
         Q_ASSERT(workspaceArea != NULL);
-        workspaceArea->endDeferLayout();
+        workspaceArea->endDeferLayout(inAnimate);
     }
 }
 
@@ -461,30 +1067,10 @@ Workspace::addWorkspaceItem(WorkspaceItem* inWidget, const QString& inName)
         addWidget(inWidget, NULL, inName);
 
         // Check and see if we need to merge menus
-        const WorkspaceItem::MenuMergeType menuMergeType = inWidget->getMenuMergeType();
-
-        switch (menuMergeType) {
-            case WorkspaceItem::ADD:
-                addItemMenus(inWidget);
-                break;
-
-            case WorkspaceItem::MERGE:
-                mergeItemMenus(inWidget);
-                break;
+        mergeMenus(inWidget);
 
-            case WorkspaceItem::REMOVE:
-                removeItemMenus(inWidget);
-                break;
-
-            case WorkspaceItem::REPLACE:
-                replaceItemMenus(inWidget);
-                break;
-
-            case WorkspaceItem::NONE:
-            default:
-                // No menus to merge
-                break;
-        }
+        // Heavy setup runs off the GUI thread while the panel shows progress
+        inWidget->startPreparation();
     } else {
         //This is neither artemis-launch time, nor load-layout time
         //The user must have clicked View->Plugin
@@ -543,6 +1129,24 @@ Workspace::setDefaultStateFile(const QString& inFile)
 }
 
 
+//-----------------------------------------------------------------------------
+// Workspace::setDefaultLayout()
+//
+/// Sets a layout compiled into the program to restore state from if no
+/// user state files are found. This takes the place of the default state
+/// file and costs no file access or parsing. The layout must outlive the
+/// workspace, which is the case for the tables tools/embed_layout.py
+/// generates.
+/// \param inLayout The default layout, or NULL to use the default state file.
+/// \sa setDefaultStateFile
+//-----------------------------------------------------------------------------
+void
+Workspace::setDefaultLayout(const EmbeddedLayout* inLayout)
+{
+    mDefaultLayout = inLayout;
+}
+
+
 //-----------------------------------------------------------------------------
 // Workspace::setUserStateFile()
 //
@@ -637,109 +1241,229 @@ Workspace::onUpdateCreatePanelsMenu(QMenu* inMenu)
 
 
 //-----------------------------------------------------------------------------
-// Workspace::addItemMenus()
+// Workspace::addItemMenus()
+//
+/// Add the WorkspaceItems menus to the Workspace menu bar.
+/// \param inItem The WorkspaceItem whose menus will be added.
+//-----------------------------------------------------------------------------
+void
+Workspace::addItemMenus(WorkspaceItem* inItem)
+{
+    Q_ASSERT(inItem != NULL);
+
+    // Get the items menus.
+    const WorkspaceItem::MenuList& menuList = inItem->getMenuList();
+    Q_FOREACH(QMenu* menu, menuList) {
+        // Add the item to the end of the menubar, before the Windows and Help menu.
+        mMenuBar->insertMenu(mWindowsAction, menu);
+    }
+
+    // Now add the item to the windows menu
+    if (mWindowsAction != NULL) {
+
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::mergeItemMenus()
+//
+/// Merge the WorkspaceItems menus intto the Workspace menu bar.
+/// \param inItem The WorkspaceItem whose menus will be merged.
+//-----------------------------------------------------------------------------
+void
+Workspace::mergeItemMenus(WorkspaceItem* /*inItem*/)
+{
+
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::removeItemMenus()
+//
+/// Remove the WorkspaceItems menus from the Workspace menu bar.
+/// \param inItem The WorkspaceItem whose menus will be removed.
+//-----------------------------------------------------------------------------
+void
+Workspace::removeItemMenus(WorkspaceItem* /*inItem*/)
+{
+
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::replaceItemMenus()
+//
+/// Replace the WorkspaceItems menus in the Workspace menu bar.
+/// \param inItem The WorkspaceItem whose menus replacing the
+/// Workspace menu items.
+//-----------------------------------------------------------------------------
+void
+Workspace::replaceItemMenus(WorkspaceItem* /*inItem*/)
+{
+
+}
+
+//-----------------------------------------------------------------------------
+// Workspace::restoreState()
+//
+/// Restore window state from one of the files specified by setDefaultStateFile
+/// or setUserStateFile. Note that state will not be saved, until after
+/// restoreState has been called.
+/// This parses and applies the state on the calling thread. Use
+/// restoreStateAsync to overlap parsing with application start up.
+//-----------------------------------------------------------------------------
+void
+Workspace::restoreState()
+{
+    // A parse may already be in flight, let it finish instead
+    if (mStatePending) {
+        waitForRestoreState();
+        return;
+    }
+
+    applyParsedState(parseStateFiles(mUserStateFile, mDefaultStateFile, mDefaultLayout));
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::restoreStateAsync()
 //
-/// Add the WorkspaceItems menus to the Workspace menu bar.
-/// \param inItem The WorkspaceItem whose menus will be added.
+/// Begin parsing the state files on a worker thread. The application can
+/// continue building its menus and plugins while the file is read. When
+/// parsing is done the result is applied on the GUI thread and the
+/// stateRestored signal is emitted. Call waitForRestoreState to block
+/// until the state is available.
 //-----------------------------------------------------------------------------
 void
-Workspace::addItemMenus(WorkspaceItem* inItem)
+Workspace::restoreStateAsync()
 {
-    Q_ASSERT(inItem != NULL);
-
-    // Get the items menus.
-    const WorkspaceItem::MenuList& menuList = inItem->getMenuList();
-    Q_FOREACH(QMenu* menu, menuList) {
-        // Add the item to the end of the menubar, before the Windows and Help menu.
-        mMenuBar->insertMenu(mWindowsAction, menu);
-    }
-
-    // Now add the item to the windows menu
-    if (mWindowsAction != NULL) {
+    if (mStatePending)
+        return;
 
-    }
+    mStatePending = true;
+    mStateWatcher->setFuture(QtConcurrent::run(&Workspace::parseStateFiles,
+                                               mUserStateFile,
+                                               mDefaultStateFile,
+                                               mDefaultLayout));
 }
 
 
 //-----------------------------------------------------------------------------
-// Workspace::mergeItemMenus()
+// Workspace::waitForRestoreState()
 //
-/// Merge the WorkspaceItems menus intto the Workspace menu bar.
-/// \param inItem The WorkspaceItem whose menus will be merged.
+/// Block until a pending restoreStateAsync has finished and apply the
+/// result immediately, without waiting for the event loop.
+/// \result True if a state file was successfully restored.
 //-----------------------------------------------------------------------------
-void
-Workspace::mergeItemMenus(WorkspaceItem* /*inItem*/)
+bool
+Workspace::waitForRestoreState()
 {
+    if (mStatePending) {
+        mStateWatcher->waitForFinished();
+        onStateParsed();
+    }
 
+    return mStateRestored;
 }
 
 
 //-----------------------------------------------------------------------------
-// Workspace::removeItemMenus()
+// Workspace::onStateParsed()  [slot]
 //
-/// Remove the WorkspaceItems menus from the Workspace menu bar.
-/// \param inItem The WorkspaceItem whose menus will be removed.
+/// The worker thread has finished parsing. Apply the result.
 //-----------------------------------------------------------------------------
 void
-Workspace::removeItemMenus(WorkspaceItem* /*inItem*/)
+Workspace::onStateParsed()
 {
+    // The result may have already been applied by waitForRestoreState
+    if (!mStatePending)
+        return;
 
+    const ParsedState theState = mStateWatcher->result();
+    applyParsedState(theState);
+
+    Q_EMIT stateRestored(theState.restored);
 }
 
 
 //-----------------------------------------------------------------------------
-// Workspace::replaceItemMenus()
+// Workspace::applyParsedState()
 //
-/// Replace the WorkspaceItems menus in the Workspace menu bar.
-/// \param inItem The WorkspaceItem whose menus replacing the
-/// Workspace menu items.
+/// Apply parsed state to the workspace. This must be called on the
+/// GUI thread.
+/// \param inState The parsed state.
 //-----------------------------------------------------------------------------
 void
-Workspace::replaceItemMenus(WorkspaceItem* /*inItem*/)
+Workspace::applyParsedState(const ParsedState& inState)
 {
+    mStatePending = false;
+    mStateRestored = inState.restored;
+    mSavedLayout = inState.layout;
 
+    if (inState.attempted && !inState.restored) {
+        //LOG_WARN("Error restoring window layout");
+    }
 }
 
+
 //-----------------------------------------------------------------------------
-// Workspace::restoreState()
+// Workspace::parseStateFiles()
 //
-/// Restore window state from one of the files specified by setDefaultStateFile
-/// or setUserStateFile. Note that state will not be saved, until after
-/// restoreState has been called.
-//-----------------------------------------------------------------------------
-void
-Workspace::restoreState()
+/// Parse the user state file, falling back to the embedded default layout
+/// or the default state file. This does not touch the workspace and is safe
+/// to run on a worker thread.
+/// \param inUserStateFile The user state file.
+/// \param inDefaultStateFile The default, possibly built-in, state file.
+/// \param inDefaultLayout The default layout compiled into the program, or NULL.
+/// \result The parsed state.
+//-----------------------------------------------------------------------------
+ParsedState
+Workspace::parseStateFiles(const QString& inUserStateFile,
+                           const QString& inDefaultStateFile,
+                           const EmbeddedLayout* inDefaultLayout)
 {
-    bool stateRestored = false;
-    bool restoreAttempted = false;
+    ParsedState theState;
 
-    if (!mUserStateFile.isEmpty()) {
-        QFile stateFile(mUserStateFile);
+    if (!inUserStateFile.isEmpty()) {
+        QFile stateFile(inUserStateFile);
         if (stateFile.exists()) {
-            restoreAttempted = true;
-            stateRestored = restoreState(&stateFile);
+            theState.attempted = true;
+            theState.restored = parseStateFile(&stateFile, theState.layout);
             // TODO mrequenes If restoreState failed, we should copy the old
             // state file to a safe place to prevent it from being overwritten.
         }
     }
     
-    if (!stateRestored && !mDefaultStateFile.isEmpty()) {
+    if (!theState.restored && inDefaultLayout != NULL) {
+        theState.attempted = true;
+        theState.layout.second.clear();
+        theState.restored = WorkspaceArea::restoreState(*inDefaultLayout, theState.layout);
+    }
+
+    if (!theState.restored && !inDefaultStateFile.isEmpty()) {
         // The default state file may be a built-in resource
-        QFile stateFile(mDefaultStateFile);
+        QFile stateFile(inDefaultStateFile);
         if (stateFile.exists()) {
-            restoreAttempted = true;
-            stateRestored = restoreState(&stateFile);
+            theState.attempted = true;
+            theState.restored = parseStateFile(&stateFile, theState.layout);
         }
     }
 
-    if (restoreAttempted && !stateRestored) {
-        //LOG_WARN("Error restoring window layout");
-    }
+    return theState;
 }
 
-// Private function
+
+//-----------------------------------------------------------------------------
+// Workspace::parseStateFile()
+//
+/// Parse a single state file into a layout.
+/// \param inFile The file to read.
+/// \param outLayout The layout to populate.
+/// \result True if the file was read.
+//-----------------------------------------------------------------------------
 bool
-Workspace::restoreState(QIODevice* inFile)
+Workspace::parseStateFile(QIODevice* inFile, WorkspaceArea::SavedLayout& outLayout)
 {
     Q_ASSERT(inFile != NULL);
 
@@ -747,61 +1471,19 @@ Workspace::restoreState(QIODevice* inFile)
     if (!inFile->open(QIODevice::ReadOnly | QIODevice::Text))
         return false;
 
-    // Clear out the cached layout.
-    mSavedLayout.second.clear();
+    // Clear out any previous attempt.
+    outLayout.second.clear();
 
-    // Get the area
-    WorkspaceArea* theArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
-    Q_ASSERT(theArea != NULL);
-    
     // Create the XML stream
     QXmlStreamReader xmlStream(inFile);
     
     // Get the Workspace area configuration
-    const bool theResult = theArea->restoreState(xmlStream, mSavedLayout);
+    const bool theResult = WorkspaceArea::restoreState(xmlStream, outLayout);
 
     // Done with the file
     inFile->close();
 
     return theResult;
-#if 0
-    quint8 marker, version;
-    stream >> marker;
-    if (marker != WorkspaceMarker) {
-        return false;
-    }
-
-    stream >> version;
-    if (version != StateFileVersion) {
-        if (version != OldStateFileVersion) {
-            return false;
-        } else {
-            QRect geom;
-            stream >> geom;
-            if(geom.isValid())
-                mMainWindow->setGeometry(geom);
-            WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
-            return workspaceArea->restoreState(stream);
-        }
-    }
-
-    bool stateRestored;
-    SavedLayout* layout = getGlobalLayout();
-    
-    // Read in the global layout
-    layout->readState(stream);
-    
-    // Read in other layout states if they exist
-    while(!stream.atEnd()) {
-        SavedLayout otherLayouts;
-        otherLayouts.readState(stream);
-        mLayoutList.push_back(otherLayouts);
-    }
-
-    // Switch to the default state. 
-    stateRestored = switchLayout(DefaultLayoutName);
-    return stateRestored;
-#endif
 }
 
 
@@ -827,10 +1509,17 @@ Workspace::restoreComplete()
 //-----------------------------------------------------------------------------
 // Workspace::switchLayout(QString layoutName)
 //
-/// Switch window to a particular layout.
+/// Switch window to a particular layout. The current panels are moved
+/// into place rather than being destroyed and created again. Panels
+/// the layout needs that don't exist yet are added as placeholders if a
+/// panel factory is registered for them, and requested from
+/// createLayoutWidget() otherwise.
+/// \param inLayoutName The name of the layout. Empty for the global layout.
+/// \param inAnimate If true, animate the panels into their new positions.
+/// \result True if the layout was found and applied.
 //-----------------------------------------------------------------------------
 bool
-Workspace::switchLayout(const QString& inLayoutName)
+Workspace::switchLayout(const QString& inLayoutName, bool inAnimate)
 {
     bool result = false;
     SavedLayout theLayout;
@@ -842,18 +1531,64 @@ Workspace::switchLayout(const QString& inLayoutName)
     }
     
     assert(result && "The layout to switch to must be found.");
+    if (!result)
+        return false;
 
-#if 0    
-    if(layout->geometry.isValid()) {
-        mMainWindow->setGeometry(layout->geometry);
-    }
+    if (theLayout.geometry.isValid())
+        mMainWindow->setGeometry(theLayout.geometry);
 
     WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
-    QDataStream wbaStream(layout->state);
-    return workspaceArea->restoreState(wbaStream);
-#endif
+    Q_ASSERT(workspaceArea != NULL);
 
-    return false;
+    beginDeferLayout();
+
+    // Create any panels the layout needs that we don't have
+    QMapIterator<QString, WorkspaceArea::SavedGroup> iter(theLayout.layout.second);
+    while (iter.hasNext()) {
+        iter.next();
+        Q_FOREACH(const QString& panelName, iter.value().panels) {
+            if (workspaceArea->findPanel(panelName) != NULL)
+                continue;
+
+            // Panels with a factory are built when they are first shown
+            if (findPanelFactory(panelName) != NULL) {
+                addPlaceholderPanel(panelName, NULL);
+                continue;
+            }
+
+            QWidget* theWidget = createLayoutWidget(panelName);
+            if (theWidget != NULL)
+                addWidget(theWidget, NULL, panelName);
+        }
+    }
+
+    // Commit the pre-solved geometry. The layout solves the grid itself
+    // if the geometry does not cover every group.
+    SolvedLayout theSolved;
+    const QString solvedName = inLayoutName.isEmpty() ? Workspace::DefaultLayoutName : inLayoutName;
+    const bool solved = getSolvedLayout(solvedName, theLayout, theSolved);
+    workspaceArea->applyLayout(theLayout.layout, false, solved ? &theSolved.geometry : NULL);
+    mSavedLayout = theLayout.layout;
+
+    endDeferLayout(inAnimate);
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::createLayoutWidget()
+//
+/// Called by switchLayout() for panels in the layout that don't exist in
+/// the workspace. Override to create the widget for the named panel.
+/// \param inName The name of the panel.
+/// \result The new widget, or NULL if the panel should be skipped.
+//-----------------------------------------------------------------------------
+QWidget*
+Workspace::createLayoutWidget(const QString& inName)
+{
+    Q_UNUSED(inName);
+    return NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -940,7 +1675,8 @@ Workspace::saveState(const QString& inLayoutName)
         //LOG_WARN_FIRST_N(1, "error saving state to file: " << mUserStateFile.toStdString().c_str());
     }
     
-    mSaveStateTimer->stop();
+    TaskScheduler::instance()->cancel(mSaveStateTaskId);
+    mSaveStateTaskId = -1;
 }
 
 
@@ -954,14 +1690,15 @@ Workspace::saveState(const QString& inLayoutName)
 bool
 Workspace::layoutExists(const QString& inLayoutName) const
 {
-    return mLayouts.contains(inLayoutName);
+    return mLayouts.contains(inLayoutName) || mLayoutLibrary->contains(inLayoutName);
 }
 
 
 //-----------------------------------------------------------------------------
 // Workspace::getSavedLayout()
 //
-/// Get the saved layout for the name.
+/// Get the saved layout for the name. Layouts that live in the layout
+/// library are decoded the first time they are asked for.
 /// \param inLayoutName The name of the layout to save.
 /// \param outLayout The layout to populate.
 /// \result True if the layout was found.
@@ -969,20 +1706,52 @@ Workspace::layoutExists(const QString& inLayoutName) const
 bool
 Workspace::getSavedLayout(const QString& inLayoutName, SavedLayout& outLayout) 
 {
-    LayoutIterator iter(mLayouts);
-    while (iter.hasNext()) {
-        iter.next();
+    SavedLayoutMap::const_iterator iter = mLayouts.find(inLayoutName);
+    if (iter != mLayouts.end()) {
+        outLayout = iter.value();
+        return true;
+    }
 
-        if (iter.key() == inLayoutName) {        
-            outLayout = iter.value();
-            return true;
-        }
+    if (mLayoutLibrary->readLayout(inLayoutName, outLayout)) {
+        mLayouts[inLayoutName] = outLayout;
+        mSolveTimer->start();
+        return true;
     }
         
     return false;
 }
 
 
+//-----------------------------------------------------------------------------
+// Workspace::openLayoutLibrary()
+//
+/// Open a layout library. Only the index of the library is read,
+/// individual layouts are decoded when they are used.
+/// \param inFileName The library file.
+/// \result True if the library was opened.
+//-----------------------------------------------------------------------------
+bool
+Workspace::openLayoutLibrary(const QString& inFileName)
+{
+    return mLayoutLibrary->open(inFileName);
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::saveLayoutLibrary()
+//
+/// Save all layouts into a layout library. Layouts in the open library
+/// that were never used are copied without being decoded.
+/// \param inFileName The library file.
+/// \result True if the library was written.
+//-----------------------------------------------------------------------------
+bool
+Workspace::saveLayoutLibrary(const QString& inFileName)
+{
+    return mLayoutLibrary->save(inFileName, mLayouts);
+}
+
+
 //-----------------------------------------------------------------------------
 // Workspace::getGlobalLayout()
 //
@@ -1018,6 +1787,270 @@ Workspace::updateSavedLayout(const QString& inLayoutName)
 
     // Update the layout
     mLayouts[inLayoutName] = theLayout;
+    invalidateSolvedLayout(inLayoutName);
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::invalidateSolvedLayouts()
+//
+/// Throw away the solved geometry of all layouts, typically because the
+/// workspace area changed size. The layouts are solved again when the
+/// workspace has been idle for a moment.
+//-----------------------------------------------------------------------------
+void
+Workspace::invalidateSolvedLayouts()
+{
+    // Results still being solved are for the old size and are dropped
+    // when they come in
+    mSolvedLayouts.clear();
+    mSolveTimer->start();
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::invalidateSolvedLayout()
+//
+/// Throw away the solved geometry of a layout that has changed.
+/// \param inLayoutName The name of the layout.
+//-----------------------------------------------------------------------------
+void
+Workspace::invalidateSolvedLayout(const QString& inLayoutName)
+{
+    // Results still being solved for this layout are for the old layout
+    ++mSolveGenerations[inLayoutName];
+    mSolvedLayouts.remove(inLayoutName);
+    mSolveTimer->start();
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::onSolveLayouts()  [slot]
+//
+/// Solve every saved layout whose geometry is missing or was solved for
+/// another size. Several layouts are solved in parallel on the global
+/// thread pool, a single one is solved right here.
+//-----------------------------------------------------------------------------
+void
+Workspace::onSolveLayouts()
+{
+    if (mMainWindow == NULL)
+        return;
+
+    // Let the current batch finish. It checks again when it is done.
+    if (mSolveWatcher->isRunning())
+        return;
+
+    QList<SolvedLayout> theRequests;
+    LayoutConstIterator iter(mLayouts);
+    while (iter.hasNext()) {
+        iter.next();
+
+        const QSize theSize = getLayoutAreaSize(iter.value());
+        if (theSize.isEmpty() || iter.value().layout.second.isEmpty())
+            continue;
+
+        const QMap<QString, QSize> theMinimumSizes = getLayoutMinimumSizes(iter.value());
+        SolvedLayoutMap::const_iterator solved = mSolvedLayouts.find(iter.key());
+        if (solved != mSolvedLayouts.end() && 
+            solved.value().size == theSize && 
+            solved.value().minimumSizes == theMinimumSizes)
+            continue;
+
+        SolvedLayout theRequest;
+        theRequest.name = iter.key();
+        theRequest.size = theSize;
+        theRequest.generation = mSolveGenerations.value(iter.key());
+        theRequest.groups = iter.value().layout.second;
+        theRequest.minimumSizes = theMinimumSizes;
+        theRequests.push_back(theRequest);
+    }
+
+    if (theRequests.isEmpty())
+        return;
+
+    if (theRequests.size() == 1) {
+        mSolvedLayouts[theRequests.first().name] = solveLayout(theRequests.first());
+        return;
+    }
+
+    mSolveWatcher->setFuture(QtConcurrent::mapped(theRequests, &Workspace::solveLayout));
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::onLayoutsSolved()  [slot]
+//
+/// The worker threads have finished solving. Keep the results whose layout
+/// has not changed and that were solved for the current area size.
+//-----------------------------------------------------------------------------
+void
+Workspace::onLayoutsSolved()
+{
+    if (mMainWindow == NULL)
+        return;
+
+    const QList<SolvedLayout> theResults = mSolveWatcher->future().results();
+    Q_FOREACH(const SolvedLayout& theResult, theResults) {
+        SavedLayoutMap::const_iterator iter = mLayouts.constFind(theResult.name);
+        if (iter == mLayouts.constEnd())
+            continue;
+
+        if (theResult.generation != mSolveGenerations.value(theResult.name))
+            continue;
+
+        if (theResult.size == getLayoutAreaSize(iter.value()))
+            mSolvedLayouts[theResult.name] = theResult;
+    }
+
+    // Pick up anything that went stale while the batch was running
+    mSolveTimer->start();
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::getSolvedLayout()
+//
+/// Get the solved geometry of a layout for the size the workspace area
+/// will have once the layout is applied. If the layout has not been
+/// solved for that size and the current size hints of its panels yet, it
+/// is solved now.
+/// \param inLayoutName The name of the layout.
+/// \param inLayout The layout.
+/// \param outSolved The solved layout to populate.
+/// \result True if the layout could be solved.
+//-----------------------------------------------------------------------------
+bool
+Workspace::getSolvedLayout(const QString& inLayoutName,
+                           const SavedLayout& inLayout,
+                           SolvedLayout& outSolved)
+{
+    const QSize theSize = getLayoutAreaSize(inLayout);
+    if (theSize.isEmpty() || inLayout.layout.second.isEmpty())
+        return false;
+
+    const QMap<QString, QSize> theMinimumSizes = getLayoutMinimumSizes(inLayout);
+    SolvedLayoutMap::const_iterator iter = mSolvedLayouts.find(inLayoutName);
+    if (iter != mSolvedLayouts.end() && 
+        iter.value().size == theSize && 
+        iter.value().minimumSizes == theMinimumSizes) {
+        outSolved = iter.value();
+        return true;
+    }
+
+    SolvedLayout theRequest;
+    theRequest.name = inLayoutName;
+    theRequest.size = theSize;
+    theRequest.generation = mSolveGenerations.value(inLayoutName);
+    theRequest.groups = inLayout.layout.second;
+    theRequest.minimumSizes = theMinimumSizes;
+
+    outSolved = solveLayout(theRequest);
+    mSolvedLayouts[inLayoutName] = outSolved;
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::getLayoutAreaSize()
+//
+/// Get the size the workspace area will have when the layout is applied.
+/// switchLayout() moves the window to the geometry saved with the layout,
+/// and the window frame around the area stays the same.
+/// \param inLayout The layout.
+/// \result The size of the workspace area.
+//-----------------------------------------------------------------------------
+QSize
+Workspace::getLayoutAreaSize(const SavedLayout& inLayout) const
+{
+    QSize theSize = mMainWindow->centralWidget()->size();
+
+    if (inLayout.geometry.isValid())
+        theSize += inLayout.geometry.size() - mMainWindow->geometry().size();
+
+    return theSize;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::getLayoutMinimumSizes()
+//
+/// Get the minimum size of each panel group of a layout, worked out from
+/// the panels the group will hold the same way the live layout does it.
+/// Panels that do not exist yet are left out. This reads the panels, so
+/// it must be called on the GUI thread before a layout is solved.
+/// \param inLayout The layout.
+/// \result The minimum size of each saved group.
+//-----------------------------------------------------------------------------
+QMap<QString, QSize>
+Workspace::getLayoutMinimumSizes(const SavedLayout& inLayout) const
+{
+    QMap<QString, QSize> theSizes;
+
+    WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(mMainWindow->centralWidget());
+    if (workspaceArea == NULL)
+        return theSizes;
+
+    QMapIterator<QString, WorkspaceArea::SavedGroup> iter(inLayout.layout.second);
+    while (iter.hasNext()) {
+        iter.next();
+
+        QList<WorkspacePanel*> thePanels;
+        Q_FOREACH(const QString& panelName, iter.value().panels) {
+            WorkspacePanel* thePanel = workspaceArea->findPanel(panelName);
+            if (thePanel != NULL)
+                thePanels.push_back(thePanel);
+        }
+
+        theSizes[iter.key()] = WorkspaceLayout::getPanelGroupMinimumSize(thePanels);
+    }
+
+    return theSizes;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::solveLayout()
+//
+/// Solve the geometry of the panel groups of a layout. This only works on
+/// the grid positions and the minimum sizes of the saved groups and is run
+/// on worker threads.
+/// \param inRequest The groups to solve and the size to solve them for.
+/// \result The solved layout.
+//-----------------------------------------------------------------------------
+SolvedLayout
+Workspace::solveLayout(const SolvedLayout& inRequest)
+{
+    SolvedLayout theResult;
+    theResult.name = inRequest.name;
+    theResult.size = inRequest.size;
+    theResult.generation = inRequest.generation;
+
+    QList<QRect> theCells;
+    QList<QSize> theMinimumSizes;
+    QMapIterator<QString, WorkspaceArea::SavedGroup> iter(inRequest.groups);
+    while (iter.hasNext()) {
+        iter.next();
+        const WorkspaceArea::SavedGroup& theGroup = iter.value();
+        theCells.push_back(QRect(theGroup.gridx, 
+                                 theGroup.gridy, 
+                                 theGroup.gridwidth, 
+                                 theGroup.gridheight));
+        theMinimumSizes.push_back(inRequest.minimumSizes.value(iter.key(), QSize(0, 0)));
+    }
+
+    QList<QRect> theBounds;
+    WorkspaceLayout::solvePanelGroups(theCells, theMinimumSizes, inRequest.size, theBounds);
+
+    int index = 0;
+    iter.toFront();
+    while (iter.hasNext()) {
+        iter.next();
+        theResult.geometry[iter.key()] = theBounds.at(index++);
+    }
+
+    return theResult;
 }
 
 
@@ -1079,6 +2112,12 @@ Workspace::getLayoutNames(QStringList& outNames)
         iter.next();
         outNames.push_back(iter.key());
     }
+
+    // Add the library layouts that have not been used yet
+    Q_FOREACH(const QString& name, mLayoutLibrary->getLayoutNames()) {
+        if (!mLayouts.contains(name))
+            outNames.push_back(name);
+    }
 }
 
 
@@ -1096,6 +2135,11 @@ Workspace::deleteLayout(const QString& inName)
     if (inName == Workspace::DefaultLayoutName)
         return false;
 
+    const bool inLibrary = mLayoutLibrary->contains(inName);
+    mLayoutLibrary->remove(inName);
+    mSolvedLayouts.remove(inName);
+    ++mSolveGenerations[inName];
+
     LayoutIterator iter(mLayouts);
     while (iter.hasNext()) {
         iter.next();
@@ -1106,7 +2150,7 @@ Workspace::deleteLayout(const QString& inName)
         }
     }
 
-    return false;
+    return inLibrary;
 }
 
 
@@ -1120,6 +2164,13 @@ Workspace::deleteLayout(const QString& inName)
 bool
 Workspace::renameLayout(const QString& inName, const QString& inNewName)
 {
+    // Make sure a library layout has been decoded before it is renamed
+    SavedLayout theLayout;
+    if (!getSavedLayout(inName, theLayout))
+        return false;
+
+    mLayoutLibrary->remove(inName);
+
     LayoutIterator iter(mLayouts);
     while (iter.hasNext()) {
         iter.next();
@@ -1131,6 +2182,8 @@ Workspace::renameLayout(const QString& inName, const QString& inNewName)
             layout.name = inNewName;       
             iter.remove();
             mLayouts[inNewName] = layout;
+            invalidateSolvedLayout(inName);
+            invalidateSolvedLayout(inNewName);
             return true;
         }
     }
@@ -1157,6 +2210,58 @@ Workspace::addPanelCreationAction(QAction* inAction)
 }
 
 
+//-----------------------------------------------------------------------------
+// Workspace::addPluginDirectory()
+//
+/// Make the WorkspacePlugins in the directory available without loading
+/// them. A panel creation action is added for each plugin from its
+/// metadata, and the plugin class name is registered as a panel factory
+/// so restored layouts create plugin panels when they are first shown.
+/// A plugin library is only loaded when an item of its class is created.
+/// \param inDirectory The directory holding the plugin libraries.
+/// \result The number of plugins added.
+/// \sa PluginCatalog
+//-----------------------------------------------------------------------------
+int
+Workspace::addPluginDirectory(const QString& inDirectory)
+{
+    PluginInfoList theAdded;
+    const int theCount = mPluginCatalog->addDirectory(inDirectory, &theAdded);
+
+    Q_FOREACH(const PluginInfo& theInfo, theAdded) {
+        registerPanelFactory(theInfo.className, mPluginCatalog);
+
+        QAction* theAction = new QAction(QIcon(theInfo.icon), theInfo.menuTitle, this);
+        theAction->setData(theInfo.className);
+        connect(theAction, SIGNAL(triggered()), this, SLOT(onCreatePluginPanel()));
+        addPanelCreationAction(theAction);
+    }
+
+    return theCount;
+}
+
+
+//-----------------------------------------------------------------------------
+// Workspace::onCreatePluginPanel() [slot]
+//
+/// Create a panel for the plugin class of the triggered creation action,
+/// loading the plugin library on first use.
+//-----------------------------------------------------------------------------
+void
+Workspace::onCreatePluginPanel()
+{
+    QAction* theAction = qobject_cast<QAction*>(sender());
+    if (theAction == NULL)
+        return;
+
+    // Each instance needs a name of its own for layouts and view state
+    const QString theClassName = theAction->data().toString();
+    WorkspaceItem* theItem = mPluginCatalog->createItem(theClassName);
+    if (theItem != NULL)
+        addWorkspaceItem(theItem, getUniquePanelName(theClassName));
+}
+
+
 //-----------------------------------------------------------------------------
 // Workspace::closePanels()
 //
@@ -22,10 +22,15 @@ THE SOFTWARE.
 #define WORKSPACE_HAS_BEEN_INCLUDED
 
 // Qt
+#include <QByteArray>
 #include <QDockWidget>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QList>
 #include <QMap>
 #include <QObject>
+#include <QRect>
+#include <QSize>
 #include <QString>
 
 // Local
@@ -41,8 +46,12 @@ class QTabWidget;
 class QTimer;
 
 class WorkspacePanel;
+struct EmbeddedLayout;
 
 namespace workspace {
+class LayoutLibrary;
+class PluginCatalog;
+class UpdateScheduler;
 class WorkspaceItem;
 }
 
@@ -70,6 +79,79 @@ struct SavedLayout
     WorkspaceArea::SavedLayout layout;
 };
 
+//=============================================================================
+// struct ParsedState
+//=============================================================================
+/*! The result of parsing the state files.
+    This is a plain value so it can be produced on a worker thread
+    and handed to the GUI thread to be applied.
+*/
+struct ParsedState
+{
+    ParsedState();
+
+    bool attempted;
+    bool restored;
+    WorkspaceArea::SavedLayout layout;
+};
+
+//=============================================================================
+// struct SolvedLayout
+//=============================================================================
+/*! The panel group geometry of a saved layout, solved for an area size.
+    Layouts are solved on worker threads while the workspace is idle, so
+    that switching to a layout only has to commit geometry.
+*/
+struct SolvedLayout
+{
+    SolvedLayout();
+
+    QString name;
+    QSize size;
+    uint generation;
+    WorkspaceArea::SavedGroups groups;
+    QMap<QString, QSize> minimumSizes;
+    QMap<QString, QRect> geometry;
+};
+
+//=============================================================================
+// struct HibernationStats
+//=============================================================================
+/*! Counters for panel hibernation.
+    \sa Workspace::setHibernationTimeout
+*/
+struct HibernationStats
+{
+    HibernationStats();
+
+    int hibernatedPanels;       // panels whose content is currently destroyed
+    qint64 viewStateBytes;      // view state held for hibernated panels
+    qint64 widgetTreeBytes;     // estimated widget memory freed by hibernating
+    int hibernations;           // content widgets destroyed so far
+    int recreations;            // content widgets created again so far
+    qint64 totalRecreateTime;   // msecs spent creating content again
+    qint64 maxRecreateTime;     // longest single recreation in msecs
+};
+
+//=============================================================================
+// class PanelFactory
+//=============================================================================
+/*! Creates the content of a panel on demand.
+    Factories are registered with the Workspace by panel name. Panels
+    restored from a layout that have a factory start out as empty
+    placeholder tabs, and the factory is asked for the content the first
+    time the panel is shown.
+*/
+class PanelFactory
+{
+public:
+    virtual ~PanelFactory();
+
+    /// Create the content widget of the named panel. A WorkspaceItem
+    /// may be returned. Return NULL to leave the panel empty.
+    virtual QWidget* createPanelWidget(const QString& inName) = 0;
+};
+
 //=============================================================================
 // class Workspace
 //=============================================================================
@@ -98,12 +180,36 @@ public:
 
     void removeWorkspaceItem(WorkspaceItem* inItem);
 
+    void registerPanelFactory(const QString& inName, PanelFactory* inFactory);
+    void unregisterPanelFactory(const QString& inName);
+    WorkspacePanel* addPlaceholderPanel(const QString& inName,
+                                        QWidget* inGroup,
+                                        const QString& inTitle = QString());
+    bool isPlaceholderPanel(WorkspacePanel* inPanel) const;
+    QString getUniquePanelName(const QString& inBaseName) const;
+    static QString getPanelBaseName(const QString& inName);
+    bool materializePanel(WorkspacePanel* inPanel);
+
+    void setHibernationTimeout(int inMinutes);
+    int hibernationTimeout() const;
+    bool hibernatePanel(WorkspacePanel* inPanel);
+    HibernationStats getHibernationStats() const;
+
+    void setAnimationPolicy(const AnimationMonitor::Policy& inPolicy);
+    const AnimationMonitor::Policy& getAnimationPolicy() const;
+
+    UpdateScheduler* getUpdateScheduler() const;
+
+    int addPluginDirectory(const QString& inDirectory);
+    PluginCatalog* getPluginCatalog() const;
+
     void beginDeferLayout();
-    void endDeferLayout();
+    void endDeferLayout(bool inAnimate = false);
 
     void setPanelContentsMargins(int left, int top, int right, int bottom);
 
     void setDefaultStateFile(const QString&);
+    void setDefaultLayout(const EmbeddedLayout* inLayout);
     void setUserStateFile(const QString&);
 
     QMainWindow* getMainWindow();
@@ -117,6 +223,9 @@ public:
     QAction* getDebugAction();
 #endif
 
+    bool openLayoutLibrary(const QString& inFileName);
+    bool saveLayoutLibrary(const QString& inFileName);
+
     bool layoutExists(const QString& inLayoutName) const;   
     bool getSavedLayout(const QString& inLayoutName, SavedLayout& outLayout);
     void getGlobalLayout(SavedLayout& outLayout);
@@ -131,6 +240,13 @@ public:
 
     static const QString DefaultLayoutName;
                     
+    void restoreStateAsync();
+    bool waitForRestoreState();
+    bool isRestoringState() const;
+
+Q_SIGNALS:
+    void stateRestored(bool inRestored);
+
 public Q_SLOTS:
     void restoreState();
     void restoreComplete();
@@ -141,7 +257,8 @@ public Q_SLOTS:
 protected:
     virtual void initMenus() = 0;
     void saveState(const QString&);
-    bool switchLayout(const QString& inName);
+    bool switchLayout(const QString& inName, bool inAnimate = false);
+    virtual QWidget* createLayoutWidget(const QString& inName);
     bool deleteLayout(const QString& inName);
     bool renameLayout(const QString& inName, const QString& inNewName);
     void getLayoutNames(QStringList& outNames);
@@ -152,6 +269,11 @@ protected:
 private Q_SLOTS:
     void setActiveSubWindow(QWidget* inWindow);
     void updateWindowsMenu();
+    void onStateParsed();
+    void onSolveLayouts();
+    void onLayoutsSolved();
+    void onHibernatePanels();
+    void onCreatePluginPanel();
 
 private:
     static const int StateFileVersion = 3;
@@ -159,21 +281,40 @@ private:
  
     bool eventFilter(QObject* inObject, QEvent* inEvent);
 
+    void initPanelWidget(WorkspacePanel* inPanel, QWidget* inWidget);
+    void mergeMenus(WorkspaceItem* inItem);
+    void unmergeMenus(WorkspaceItem* inItem);
+    PanelFactory* findPanelFactory(const QString& inName) const;
     void addItemMenus(WorkspaceItem* inItem);
     void mergeItemMenus(WorkspaceItem* inItem);
     void removeItemMenus(WorkspaceItem* inItem);
     void replaceItemMenus(WorkspaceItem* inItem);
 
-    bool restoreState(QIODevice* inFile);
+    static ParsedState parseStateFiles(const QString& inUserStateFile,
+                                       const QString& inDefaultStateFile,
+                                       const EmbeddedLayout* inDefaultLayout);
+    static bool parseStateFile(QIODevice* inFile, WorkspaceArea::SavedLayout& outLayout);
+    void applyParsedState(const ParsedState& inState);
 
     void initializeDockInfo();
     void startSaveStateTimer();
     
     void updateSavedLayout(const QString& inLayoutName);
 
+    void invalidateSolvedLayouts();
+    void invalidateSolvedLayout(const QString& inLayoutName);
+    bool getSolvedLayout(const QString& inLayoutName,
+                         const SavedLayout& inLayout,
+                         SolvedLayout& outSolved);
+    QSize getLayoutAreaSize(const SavedLayout& inLayout) const;
+    QMap<QString, QSize> getLayoutMinimumSizes(const SavedLayout& inLayout) const;
+    static SolvedLayout solveLayout(const SolvedLayout& inRequest);
+    static qint64 estimateWidgetTreeBytes(QWidget* inWidget);
+
     typedef QMap<QString, SavedLayout> SavedLayoutMap;
     typedef QMapIterator<QString, SavedLayout> LayoutConstIterator;
     typedef QMutableMapIterator<QString, SavedLayout> LayoutIterator;
+    typedef QMap<QString, SolvedLayout> SolvedLayoutMap;
 
     QSignalMapper* mWindowMapper;
 
@@ -193,7 +334,11 @@ private:
     
     QString mDefaultStateFile;
     QString mUserStateFile;
-    QTimer* mSaveStateTimer;
+    const EmbeddedLayout* mDefaultLayout;
+    int mSaveStateTaskId;
+    QFutureWatcher<ParsedState>* mStateWatcher;
+    bool mStatePending;
+    bool mStateRestored;
 
     WorkspaceItemList mWorkspaceItems;
     int mPanelContentsMarginLeft;
@@ -205,6 +350,25 @@ private:
     int mLayoutDeferrals;
 
     SavedLayoutMap mLayouts;
+    LayoutLibrary* mLayoutLibrary;
+    QMap<QString, PanelFactory*> mPanelFactories;
+
+    int mHibernateTaskId;
+    int mHibernationTimeout;
+    QMap<QString, QElapsedTimer> mHiddenSince;
+    QMap<QString, QByteArray> mViewStates;
+    QMap<QString, qint64> mWidgetTreeBytes;
+    HibernationStats mHibernationStats;
+
+    AnimationMonitor::Policy mAnimationPolicy;
+
+    UpdateScheduler* mUpdateScheduler;
+    PluginCatalog* mPluginCatalog;
+
+    SolvedLayoutMap mSolvedLayouts;
+    QTimer* mSolveTimer;
+    QFutureWatcher<SolvedLayout>* mSolveWatcher;
+    QMap<QString, uint> mSolveGenerations;
     PanelCreationActionList mCreationActionList;
 
     WorkspaceArea::SavedLayout mSavedLayout;
@@ -223,6 +387,11 @@ inline QAction* Workspace::getDebugAction() { return mDebugAction; }
 
 inline const PanelCreationActionList& Workspace::getCreationActionList() const { return mCreationActionList; }
 inline const WorkspaceArea::SavedLayout& Workspace::getCurrentLayout() const { return mSavedLayout; }
+inline bool Workspace::isRestoringState() const { return mStatePending; }
+inline int Workspace::hibernationTimeout() const { return mHibernationTimeout; }
+inline const AnimationMonitor::Policy& Workspace::getAnimationPolicy() const { return mAnimationPolicy; }
+inline UpdateScheduler* Workspace::getUpdateScheduler() const { return mUpdateScheduler; }
+inline PluginCatalog* Workspace::getPluginCatalog() const { return mPluginCatalog; }
 
 } // namespace workspace
 
@@ -27,14 +27,20 @@ THE SOFTWARE.
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPaintEvent>
+#include <QSet>
+#include <QShowEvent>
 #include <QStyleOptionTabV3>
 #include <QtDebug>
 #include <QTabWidget>
 #include <QXmlStreamWriter>
 
 // Local
+#include "EmbeddedLayout.h"
+#include "FloatingWindowPool.h"
+#include "TaskScheduler.h"
 #include "WorkspaceLayout.h"
 #include "WorkspacePanel.h"
+#include "WorkspacePanelDropIndicator.h"
 #include "WorkspacePanelGroup.h"
 #include "WorkspaceTabBar.h"
 #include "WorkspaceUtils.h"
@@ -94,6 +100,8 @@ WorkspaceArea::WorkspaceArea(QWidget* parent)
     ,   mActiveGroup(NULL)
     ,   mActivePanel(NULL)
     ,   mLayoutName(kDefaultLayoutName)
+    ,   mExposureUpdatePending(false)
+    ,   mFloatingWindowPool(NULL)
 {
     setObjectName("WorkspaceArea");
 
@@ -117,9 +125,15 @@ WorkspaceArea::init()
 
     mDragState = new DragState();
 
+    // Frames for panels undocked from this area
+    mFloatingWindowPool = new FloatingWindowPool(this);
+
     // Create the layout and set up the signal redirection
     WorkspaceLayout* theLayout = new WorkspaceLayout(this);
     setLayout(theLayout);
+
+    // Panel groups are suspended while the layout animates them
+    connect(theLayout, SIGNAL(animationStateChanged()), SLOT(scheduleExposureUpdate()));
 }
 
 
@@ -154,7 +168,7 @@ WorkspaceArea::addPanel(WorkspacePanel* inPanel, Qt::Orientation inOrientation)
     if (findFloatingPanelPlaceHolder(inPanel->objectName(), ph)) {
         inPanel->show();
         inPanel->setFloating(true);
-        inPanel->setGeometry(ph.geometry);
+        inPanel->window()->setGeometry(ph.geometry);
     } else {
         if (mActivePanel != NULL) {
             // Insert the new panel into the same group as the active panel.
@@ -181,13 +195,12 @@ WorkspaceArea::addFloatingPanel(WorkspacePanel* panel)
         panel->setParent(this);
 
     panel->show();
+    panel->setFloating(true);
 
     FloatingPanelPlaceHolder ph;
     if (findFloatingPanelPlaceHolder(panel->objectName(), ph)) {
-        panel->setGeometry(ph.geometry);
+        panel->window()->setGeometry(ph.geometry);
     }
-
-    panel->setFloating(true);
 }
 
 
@@ -268,13 +281,49 @@ WorkspaceArea::beginDeferLayout()
 
 //-----------------------------------------------------------------------------
 // WorkspaceArea::endDeferLayout()
+//
+/// Finish deferring and lay out the panels.
+/// \param inAnimate If true, animate the panels into their new positions.
 //-----------------------------------------------------------------------------
 void
-WorkspaceArea::endDeferLayout()
+WorkspaceArea::endDeferLayout(bool inAnimate)
 {
     WorkspaceLayout* workspaceLayout = qobject_cast<WorkspaceLayout*>(layout());
     Q_ASSERT(layout != NULL);
+    workspaceLayout->setAnimate(inAnimate);
     workspaceLayout->endDeferLayout();
+    workspaceLayout->setAnimate(false);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::setAnimationPolicy()
+//
+/// Set how the animations of this area are shortened or skipped when
+/// they cannot run smoothly. This covers the panel group motions, the
+/// drop indicator fades and the drop zone prelighting.
+/// \param inPolicy The policy.
+/// \sa AnimationMonitor
+//-----------------------------------------------------------------------------
+void
+WorkspaceArea::setAnimationPolicy(const AnimationMonitor::Policy& inPolicy)
+{
+    WorkspaceLayout* workspaceLayout = qobject_cast<WorkspaceLayout*>(layout());
+    Q_ASSERT(workspaceLayout != NULL);
+    workspaceLayout->setAnimationPolicy(inPolicy);
+    workspaceLayout->getDropIndicator()->setAnimationPolicy(inPolicy);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::getAnimationPolicy()
+//-----------------------------------------------------------------------------
+const AnimationMonitor::Policy&
+WorkspaceArea::getAnimationPolicy() const
+{
+    WorkspaceLayout* workspaceLayout = qobject_cast<WorkspaceLayout*>(layout());
+    Q_ASSERT(workspaceLayout != NULL);
+    return workspaceLayout->animationPolicy();
 }
 
 
@@ -289,6 +338,12 @@ WorkspaceArea::removePanel(WorkspacePanel* inPanel)
 {
     Q_ASSERT(inPanel != NULL);
 
+    // Parked panels are not in the layout
+    if (mParkedPanels.value(inPanel->objectName()) == inPanel) {
+        mParkedPanels.remove(inPanel->objectName());
+        return;
+    }
+
     WorkspaceLayout* theLayout = qobject_cast<WorkspaceLayout*>(layout());
     Q_ASSERT(theLayout != NULL);
     
@@ -326,6 +381,12 @@ WorkspaceArea::getPanelList(QList<WorkspacePanel*>& outList)
                 outList.push_back(thePanel);
         }
     }
+
+    // Parked panels are still open, just not in the current layout
+    Q_FOREACH(const QPointer<WorkspacePanel>& thePanel, mParkedPanels) {
+        if (thePanel != NULL)
+            outList.push_back(thePanel);
+    }
 }
 
 
@@ -383,7 +444,6 @@ WorkspaceArea::setActivePanel(WorkspacePanel* inPanel)
 	if (inPanel != NULL) {
     	mActivePanel = inPanel;
     	mActivePanel->setActive(true);
-    	mActivePanel->update();
 
         // Find the tab bar that belongs to this widget and activate it.
         WorkspaceLayout::GridConstIterator iter(theLayout->getConstraintsMap());
@@ -557,7 +617,7 @@ WorkspaceArea::saveState(QXmlStreamWriter& inStream, bool inStandAlone) const
     inStream.writeAttribute(kCountAttribute, QString::number(floatingPanels.count()));
     Q_FOREACH(WorkspacePanel* thePanel, floatingPanels) {
         inStream.writeStartElement(kPanelElement);
-        const QRect& frame = thePanel->frameGeometry();
+        const QRect frame = thePanel->window()->frameGeometry();
         inStream.writeAttribute(kXAttribute, QString::number(frame.x()));
         inStream.writeAttribute(kYAttribute, QString::number(frame.y()));
         inStream.writeAttribute(kWidthAttribute, QString::number(frame.width()));
@@ -650,7 +710,7 @@ WorkspaceArea::saveState(SavedLayout& outLayout) const
 /// \param inGroups The groups to save into the file.
 //----------------------------------------------------------------------------
 void
-WorkspaceArea::saveState(QXmlStreamWriter& inStream, const SavedGroups& inGroups) const
+WorkspaceArea::saveState(QXmlStreamWriter& inStream, const SavedGroups& inGroups)
 {
     // Write out the panel groups
     inStream.writeStartElement(kGroupsElement);
@@ -690,7 +750,9 @@ WorkspaceArea::saveState(QXmlStreamWriter& inStream, const SavedGroups& inGroups
 //-----------------------------------------------------------------------------
 // WorkspaceArea::restoreState()
 // 
-/// Restore the layout information from a file.
+/// Restore the layout information from a file. This only parses the
+/// stream and does not touch any widgets, so it is safe to call from a
+/// worker thread.
 /// \param inFile The file to read.
 /// \param outLayout The SavedGroups object to be populated.
 /// \param inStandAlone If true, make layout self contained in file.
@@ -767,6 +829,48 @@ WorkspaceArea::restoreState(QXmlStreamReader& inStream, SavedLayout& outLayout)
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspaceArea::restoreState()
+// 
+/// Restore the layout information from a layout compiled into the binary.
+/// Groups are named the same way as when reading a layout file.
+/// \param inLayout The embedded layout.
+/// \param outLayout The SavedLayout to be populated.
+/// \result True if reading was successful.
+/// \sa EmbeddedLayout
+//----------------------------------------------------------------------------
+bool
+WorkspaceArea::restoreState(const EmbeddedLayout& inLayout, SavedLayout& outLayout)
+{
+    outLayout.first = QString::fromUtf8(inLayout.name);
+
+    SavedGroups& theGroups = outLayout.second;
+
+    for (int groupIndex = 0; groupIndex < inLayout.groupCount; ++groupIndex) {
+        const EmbeddedPanelGroup& theGroup = inLayout.groups[groupIndex];
+
+        SavedGroup layoutData;
+        layoutData.name = QString::fromUtf8(theGroup.name);
+        layoutData.gridx = theGroup.gridx;
+        layoutData.gridy = theGroup.gridy;
+        layoutData.gridwidth = theGroup.gridwidth;
+        layoutData.gridheight = theGroup.gridheight;
+        layoutData.x = theGroup.x;
+        layoutData.y = theGroup.y;
+        layoutData.width = theGroup.width;
+        layoutData.height = theGroup.height;
+        layoutData.active = theGroup.active;
+
+        for (int panelIndex = 0; panelIndex < theGroup.panelCount; ++panelIndex)
+            layoutData.panels.push_back(QString::fromUtf8(theGroup.panels[panelIndex]));
+
+        theGroups["Panel Group " + QString::number(groupIndex)] = layoutData;
+    }
+
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // WorkspaceArea::restoreComplete()
 //
@@ -789,6 +893,296 @@ WorkspaceArea::restoreComplete()
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspaceArea::applyLayout()
+//
+/// Rearrange the existing panels to match a saved layout. Rather than
+/// tearing the workspace down and building it again, panel groups are
+/// reused and panels are moved or retabbed into place, so their widgets
+/// stay alive. Panels that are not part of the layout are hidden and kept
+/// so a later switch can bring them back. The grid is solved once, when
+/// all of the changes have been made. If the geometry of the groups has
+/// already been solved, it is committed instead of solving the grid.
+/// \param inLayout The layout to apply.
+/// \param inAnimate If true, animate the groups into their new positions.
+/// \param inGeometry The solved geometry of each saved group, or NULL.
+/// \result The names of panels in the layout that could not be found.
+//-----------------------------------------------------------------------------
+QStringList
+WorkspaceArea::applyLayout(const SavedLayout& inLayout, 
+                           bool inAnimate,
+                           const QMap<QString, QRect>* inGeometry)
+{
+    WorkspaceLayout* workspaceLayout = qobject_cast<WorkspaceLayout*>(layout());
+    Q_ASSERT(workspaceLayout != NULL);
+
+    const SavedGroups& savedGroups = inLayout.second;
+
+    // Get the names of all the panels the layout wants
+    QSet<QString> wantedPanels;
+    QMapIterator<QString, SavedGroup> savedIter(savedGroups);
+    while (savedIter.hasNext()) {
+        savedIter.next();
+        Q_FOREACH(const QString& panelName, savedIter.value().panels)
+            wantedPanels.insert(panelName);
+    }
+
+    // Hold off on the layout until everything is in place. The caller
+    // may already be deferring.
+    const bool wasDeferred = workspaceLayout->deferLayout();
+    if (!wasDeferred)
+        workspaceLayout->beginDeferLayout();
+
+    // Find the panels we can reuse and park the ones we can't
+    QMap<QString, WorkspacePanel*> thePanels;
+    QMapIterator<QString, QPointer<WorkspacePanel> > parkedIter(mParkedPanels);
+    while (parkedIter.hasNext()) {
+        parkedIter.next();
+        if (parkedIter.value() != NULL)
+            thePanels[parkedIter.key()] = parkedIter.value();
+    }
+
+    QList<WorkspacePanelGroup*> freeGroups;
+
+    const QList<QWidget*> theWidgets = workspaceLayout->getConstraintsMap().keys();
+    Q_FOREACH(QWidget* widget, theWidgets) {
+        WorkspacePanelGroup* theGroup = qobject_cast<WorkspacePanelGroup*>(widget);
+        if (theGroup == NULL)
+            continue;
+
+        freeGroups.push_back(theGroup);
+
+        for (int index = theGroup->count() - 1; index >= 0; --index) {
+            WorkspacePanel* thePanel = qobject_cast<WorkspacePanel*>(theGroup->widget(index));
+            if (thePanel == NULL)
+                continue;
+
+            if (wantedPanels.contains(thePanel->objectName()))
+                thePanels[thePanel->objectName()] = thePanel;
+            else
+                parkPanel(theGroup, thePanel);
+        }
+    }
+
+    // Match each saved group with the free group that already holds
+    // most of its panels.
+    QList<WorkspacePanelGroup*> targetGroups;
+    savedIter.toFront();
+    while (savedIter.hasNext()) {
+        savedIter.next();
+
+        WorkspacePanelGroup* bestGroup = NULL;
+        int bestCount = 0;
+        Q_FOREACH(WorkspacePanelGroup* theGroup, freeGroups) {
+            int count = 0;
+            Q_FOREACH(const QString& panelName, savedIter.value().panels) {
+                WorkspacePanel* thePanel = thePanels.value(panelName);
+                if (thePanel != NULL && theGroup->indexOf(thePanel) != -1)
+                    ++count;
+            }
+
+            if (count > bestCount) {
+                bestGroup = theGroup;
+                bestCount = count;
+            }
+        }
+
+        freeGroups.removeOne(bestGroup);
+        targetGroups.push_back(bestGroup);
+    }
+
+    // Saved groups without a match take any group that is left over
+    for (int index = 0; index < targetGroups.size() && !freeGroups.isEmpty(); ++index) {
+        if (targetGroups[index] == NULL)
+            targetGroups[index] = freeGroups.takeFirst();
+    }
+
+    // Move the panels into place
+    QStringList missingPanels;
+    int groupIndex = 0;
+    savedIter.toFront();
+    while (savedIter.hasNext()) {
+        savedIter.next();
+
+        WorkspacePanelGroup* theGroup = targetGroups[groupIndex];
+        int tabIndex = 0;
+
+        Q_FOREACH(const QString& panelName, savedIter.value().panels) {
+            WorkspacePanel* thePanel = thePanels.value(panelName);
+            if (thePanel == NULL) {
+                missingPanels.push_back(panelName);
+                continue;
+            }
+
+            mParkedPanels.remove(panelName);
+
+            if (theGroup == NULL) {
+                // Nothing to reuse. Take the panel out of its old group
+                // first, as below. The old group may be the target of a
+                // later saved group, so it is kept even when it empties.
+                // Then let the layout create a new group.
+                WorkspacePanelGroup* oldGroup = workspaceLayout->findPanelGroup(thePanel);
+                if (oldGroup != NULL)
+                    oldGroup->removeTab(oldGroup->indexOf(thePanel));
+                workspaceLayout->addPanel(thePanel, Qt::Horizontal);
+                theGroup = workspaceLayout->findPanelGroup(thePanel);
+            } else {
+                const int currentIndex = theGroup->indexOf(thePanel);
+                if (currentIndex == -1) {
+                    // Retab the panel from its old group
+                    WorkspacePanelGroup* oldGroup = workspaceLayout->findPanelGroup(thePanel);
+                    if (oldGroup != NULL)
+                        oldGroup->removeTab(oldGroup->indexOf(thePanel));
+                    theGroup->insertTab(tabIndex, thePanel, panelName);
+                } else if (currentIndex != tabIndex) {
+                    theGroup->getTabBar()->moveTab(currentIndex, tabIndex);
+                }
+            }
+
+            ++tabIndex;
+        }
+
+        // A group whose panels are all missing is not needed
+        if (theGroup != NULL && theGroup->count() == 0) {
+            freeGroups.push_back(theGroup);
+            theGroup = NULL;
+        }
+
+        targetGroups[groupIndex++] = theGroup;
+    }
+
+    // A group may have been emptied after it was filled, when a panel it
+    // still held went on to a later group
+    for (int index = 0; index < targetGroups.size(); ++index) {
+        if (targetGroups[index] != NULL && targetGroups[index]->count() == 0) {
+            freeGroups.push_back(targetGroups[index]);
+            targetGroups[index] = NULL;
+        }
+    }
+
+    // Get rid of the groups that were not reused
+    Q_FOREACH(WorkspacePanelGroup* theGroup, freeGroups) {
+        Q_ASSERT(theGroup->count() == 0);
+
+        if (theGroup == mActiveGroup)
+            mActiveGroup = NULL;
+
+        workspaceLayout->removePanelGroup(theGroup);
+        theGroup->hide();
+        theGroup->deleteLater();
+    }
+
+    // Place the groups on the grid. The geometry was solved for all of the
+    // saved groups, so it does not fit a grid that lost one of them.
+    QMap<QWidget*, QRect> theGeometry;
+    bool geometryFits = inGeometry != NULL;
+    groupIndex = 0;
+    savedIter.toFront();
+    while (savedIter.hasNext()) {
+        savedIter.next();
+
+        WorkspacePanelGroup* theGroup = targetGroups[groupIndex++];
+        if (theGroup == NULL) {
+            geometryFits = false;
+            continue;
+        }
+
+        const SavedGroup& savedGroup = savedIter.value();
+        theGroup->setCurrentIndex(qBound(0, savedGroup.active, theGroup->count() - 1));
+        theGroup->setConstraints(savedGroup.gridx,
+                                 savedGroup.gridy,
+                                 savedGroup.gridwidth,
+                                 savedGroup.gridheight);
+
+        if (inGeometry != NULL && inGeometry->contains(savedIter.key()))
+            theGeometry[theGroup] = inGeometry->value(savedIter.key());
+    }
+
+    // The layout falls back to solving if any group is left out
+    if (geometryFits)
+        workspaceLayout->setPendingGeometry(theGeometry);
+
+    if (!inLayout.first.isEmpty())
+        setLayoutName(inLayout.first);
+
+    // Solve the layout once
+    if (!wasDeferred)
+        endDeferLayout(inAnimate);
+
+    return missingPanels;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::parkPanel()
+//
+/// Take a panel out of its group and hide it, keeping it alive so that
+/// it can be reused by a later layout. The entry is guarded, so a parked
+/// panel deleted elsewhere simply drops out.
+/// \param inGroup The group holding the panel.
+/// \param inPanel The panel to park.
+//-----------------------------------------------------------------------------
+void
+WorkspaceArea::parkPanel(WorkspacePanelGroup* inGroup, WorkspacePanel* inPanel)
+{
+    Q_ASSERT(inGroup != NULL);
+    Q_ASSERT(inPanel != NULL);
+
+    if (inPanel == mActivePanel)
+        setActivePanel(NULL);
+
+    inGroup->removeTab(inGroup->indexOf(inPanel));
+
+    // Reparent so the panel survives its group being deleted
+    inPanel->hide();
+    inPanel->setParent(this);
+
+    // Forget panels that were deleted while parked
+    QMutableMapIterator<QString, QPointer<WorkspacePanel> > iter(mParkedPanels);
+    while (iter.hasNext()) {
+        if (iter.next().value() == NULL)
+            iter.remove();
+    }
+
+    mParkedPanels[inPanel->objectName()] = inPanel;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::findPanel()
+//
+/// Find a docked or parked panel by name.
+/// \param inName The object name of the panel.
+/// \result The panel, or NULL if none is found.
+//-----------------------------------------------------------------------------
+WorkspacePanel*
+WorkspaceArea::findPanel(const QString& inName) const
+{
+    WorkspacePanel* thePanel = mParkedPanels.value(inName);
+    if (thePanel != NULL)
+        return thePanel;
+
+    WorkspaceLayout* workspaceLayout = qobject_cast<WorkspaceLayout*>(layout());
+    Q_ASSERT(workspaceLayout != NULL);
+
+    WorkspaceLayout::GridConstIterator iter(workspaceLayout->getConstraintsMap());
+    while (iter.hasNext()) {
+        iter.next();
+        WorkspacePanelGroup* theGroup = qobject_cast<WorkspacePanelGroup*>(iter.key());
+        if (theGroup == NULL)
+            continue;
+
+        for (int index = 0; index < theGroup->count(); ++index) {
+            thePanel = qobject_cast<WorkspacePanel*>(theGroup->widget(index));
+            if (thePanel != NULL && thePanel->objectName() == inName)
+                return thePanel;
+        }
+    }
+
+    return NULL;
+}
+
+
 //-----------------------------------------------------------------------------
 // WorkspaceArea::mousePressEvent()
 //----------------------------------------------------------------------------
@@ -878,6 +1272,131 @@ WorkspaceArea::paintEvent(QPaintEvent* paintEvent)
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspaceArea::showEvent()
+//----------------------------------------------------------------------------
+void
+WorkspaceArea::showEvent(QShowEvent* event)
+{
+    // Watch the top level window so panels can be suspended while it
+    // is minimized. Installing the same filter twice is harmless.
+    if (window() != this)
+        window()->installEventFilter(this);
+
+    // Create the floating frames once the application has settled
+    TaskScheduler::instance()->postIdleTask(mFloatingWindowPool, SLOT(reserve()));
+
+    QWidget::showEvent(event);
+    scheduleExposureUpdate();
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::eventFilter()
+//----------------------------------------------------------------------------
+bool
+WorkspaceArea::eventFilter(QObject* inObject, QEvent* inEvent)
+{
+    if (inObject == window()) {
+        switch (inEvent->type()) {
+            case QEvent::WindowStateChange:
+            case QEvent::Show:
+            case QEvent::Hide:
+                scheduleExposureUpdate();
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return QWidget::eventFilter(inObject, inEvent);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::scheduleExposureUpdate() [slot]
+//
+/// Request that the exposure state of all panels be recomputed. Requests
+/// are coalesced so a burst of show, hide and move events results in a
+/// single update from the event loop.
+/// \sa WorkspacePanel::exposure
+//----------------------------------------------------------------------------
+void
+WorkspaceArea::scheduleExposureUpdate()
+{
+    if (mExposureUpdatePending)
+        return;
+
+    mExposureUpdatePending = true;
+    QMetaObject::invokeMethod(this, "updateExposure", Qt::QueuedConnection);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::updateExposure() [slot]
+//
+/// Compute the exposure state of every panel in the area, docked or
+/// floating, and push it to the panels.
+//----------------------------------------------------------------------------
+void
+WorkspaceArea::updateExposure()
+{
+    mExposureUpdatePending = false;
+
+    const QList<WorkspacePanel*> thePanels = findChildren<WorkspacePanel*>();
+
+    // Gather the screen area covered by floating panels and panel groups
+    QRegion floatingRegion;
+    QSet<QWidget*> floatingWindows;
+    Q_FOREACH(WorkspacePanel* thePanel, thePanels) {
+        QWidget* theWindow = thePanel->window();
+        if (theWindow != window() && theWindow->isVisible() && !floatingWindows.contains(theWindow)) {
+            floatingWindows.insert(theWindow);
+            floatingRegion += theWindow->frameGeometry();
+        }
+    }
+
+    Q_FOREACH(WorkspacePanel* thePanel, thePanels)
+        thePanel->setExposure(computeExposure(thePanel, floatingRegion));
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceArea::computeExposure()
+//
+/// Compute the exposure state of a single panel.
+/// \param inPanel The panel.
+/// \param inFloating The global area covered by floating windows.
+/// \result The exposure state of the panel.
+//----------------------------------------------------------------------------
+WorkspacePanel::Exposure
+WorkspaceArea::computeExposure(WorkspacePanel* inPanel, const QRegion& inFloating) const
+{
+    if (inPanel->window()->isMinimized())
+        return WorkspacePanel::ExposureSuspended;
+
+    // Covers non-current tabs, closed panels and hidden windows
+    if (!inPanel->isVisible())
+        return WorkspacePanel::ExposureBackground;
+
+    if (inPanel->isWindow() || inPanel->window() != window())
+        return WorkspacePanel::ExposureVisible;
+
+    // Docked panel groups are suspended while the layout animates them
+    WorkspaceLayout* theLayout = qobject_cast<WorkspaceLayout*>(layout());
+    WorkspacePanelGroup* theGroup = WorkspaceUtils::findParent<WorkspacePanelGroup>(inPanel);
+    if (theLayout != NULL && theGroup != NULL && theLayout->isAnimating(theGroup))
+        return WorkspacePanel::ExposureSuspended;
+
+    const QRect globalRect(inPanel->mapToGlobal(QPoint(0, 0)), inPanel->size());
+    if (!inFloating.isEmpty() && QRegion(globalRect).subtracted(inFloating).isEmpty())
+        return WorkspacePanel::ExposureOccluded;
+
+    return WorkspacePanel::ExposureVisible;
+}
+
+
 //-----------------------------------------------------------------------------
 // WorkspaceArea::adjustCursor()
 //----------------------------------------------------------------------------
@@ -1088,6 +1607,12 @@ WorkspaceArea::closePanels()
         Q_ASSERT(theGroup != NULL);
         removePanelGroup(theGroup);
     }
+
+    // Parked panels belong to no group, so close them here
+    const QList<QPointer<WorkspacePanel> > theParked = mParkedPanels.values();
+    mParkedPanels.clear();
+    Q_FOREACH(const QPointer<WorkspacePanel>& thePanel, theParked)
+        delete thePanel.data();
 }
 
 
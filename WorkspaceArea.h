@@ -23,17 +23,23 @@ THE SOFTWARE.
 
 // Qt
 #include <QColor>
+#include <QPointer>
 #include <QRegion>
 #include <QWidget>
 #include <QXmlStreamReader>
 
+// Local
+#include "AnimationMonitor.h"
+#include "WorkspacePanel.h"
+
 // Forward declarations
 class QIODevice;
 class QMenu;
 class QTabWidget;
 class QXmlStreamReader;
+class FloatingWindowPool;
 class WorkspacePanelGroup;
-class WorkspacePanel;
+struct EmbeddedLayout;
 
 struct FloatingPanelPlaceHolder
 {
@@ -100,7 +106,10 @@ public:
     void closePanels();
     
     void beginDeferLayout();
-    void endDeferLayout();
+    void endDeferLayout(bool inAnimate = false);
+
+    void setAnimationPolicy(const AnimationMonitor::Policy& inPolicy);
+    const AnimationMonitor::Policy& getAnimationPolicy() const;
     
     void getPanelList(QList<WorkspacePanel*>& outList);
     WorkspacePanel* getActivePanel();
@@ -109,11 +118,17 @@ public:
 
     void saveState(QXmlStreamWriter& inStream, bool inStandAlone = false) const;
     void saveState(SavedLayout& outLayout) const;
-    void saveState(QXmlStreamWriter& inStream, const SavedGroups& inGroups) const;
+    static void saveState(QXmlStreamWriter& inStream, const SavedGroups& inGroups);
 
-    bool restoreState(QXmlStreamReader& inStream, SavedLayout& outLayout);
+    static bool restoreState(QXmlStreamReader& inStream, SavedLayout& outLayout);
+    static bool restoreState(const EmbeddedLayout& inLayout, SavedLayout& outLayout);
     void restoreComplete();
 
+    QStringList applyLayout(const SavedLayout& inLayout, 
+                            bool inAnimate = false,
+                            const QMap<QString, QRect>* inGeometry = NULL);
+    WorkspacePanel* findPanel(const QString& inName) const;
+
     void populateCreatePanelsMenu(QMenu* inMenu);
 
     bool renamePanel(QTabWidget* inTabBar, const QString& inName);
@@ -122,9 +137,14 @@ public:
 
     const QString& getLayoutName() const;
     void setLayoutName(const QString& inName);
+
+    FloatingWindowPool* getFloatingWindowPool() const;
     
     static QColor ActivePanelColor;
 
+public Q_SLOTS:
+    void scheduleExposureUpdate();
+
 Q_SIGNALS:
     void updateCreatePanelsMenu(QMenu* inMenu);
   
@@ -134,6 +154,13 @@ protected:
     void mousePressEvent(QMouseEvent* event);
     void mouseReleaseEvent(QMouseEvent* event);
     void paintEvent(QPaintEvent* paintEvent);
+    void showEvent(QShowEvent* event);
+
+    // QObject override
+    bool eventFilter(QObject* inObject, QEvent* inEvent);
+
+private Q_SLOTS:
+    void updateExposure();
 
 private:
     // No copying
@@ -156,17 +183,26 @@ private:
 
     void updateSplitter(const QPoint& inPosition);
 
+    void parkPanel(WorkspacePanelGroup* inGroup, WorkspacePanel* inPanel);
+
+    WorkspacePanel::Exposure computeExposure(WorkspacePanel* inPanel,
+                                             const QRegion& inFloating) const;
+
     QList<FloatingPanelPlaceHolder> mFloatingPanelPlaceHolders;
+    QMap<QString, QPointer<WorkspacePanel> > mParkedPanels;
     DragState* mDragState;
 
     WorkspacePanelGroup* mActiveGroup;
     WorkspacePanel* mActivePanel;
     QString mLayoutName;
+    bool mExposureUpdatePending;
+    FloatingWindowPool* mFloatingWindowPool;
     
     friend QDebug operator << (QDebug dbg, const DragState& dragState);
 };
 inline const QString& WorkspaceArea::getLayoutName() const { return mLayoutName; }
 inline void WorkspaceArea::setLayoutName(const QString& inName) { mLayoutName = inName; }
+inline FloatingWindowPool* WorkspaceArea::getFloatingWindowPool() const { return mFloatingWindowPool; }
 
 
 #endif // !WORKSPACEAREA_HAS_BEEN_INCLUDED
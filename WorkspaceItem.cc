@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <QApplication>
 #include <QCloseEvent>
 #include <QEvent>
+#include <QFutureInterface>
 #include <QMenu>
 #include <QVBoxLayout>
 
@@ -73,7 +74,8 @@ WorkspaceItem::WorkspaceItem(Workspace* inWorkspace,
       mMenuMergeType(NONE),
       mLayout(NULL),
       mCentralWidget(NULL),
-      mOwningPanel(NULL)
+      mOwningPanel(NULL),
+      mPrepareWatcher(NULL)
 {
     Q_ASSERT(mWorkspace != NULL);
 
@@ -97,6 +99,11 @@ WorkspaceItem::WorkspaceItem(Workspace* inWorkspace,
 //-----------------------------------------------------------------------------
 WorkspaceItem::~WorkspaceItem()
 {
+    // By now the members of a subclass that prepare() works on are gone,
+    // so the subclass has to cancel in its own destructor
+    Q_ASSERT(mPrepareWatcher == NULL);
+    cancelPreparation();
+
     if (mWorkspace != NULL)
         mWorkspace->removeWorkspaceItem(this);
 }
@@ -327,6 +334,38 @@ WorkspaceItem::getDockPlacementHint() const
     return Qt::AllDockWidgetAreas;
 }
 
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::saveViewState()
+//
+/// Save the view state of the item, such as scroll positions, zoom and
+/// selection, before the Workspace destroys it to free memory. The item is
+/// created again by its panel factory and handed the state through
+/// restoreViewState() when its panel is shown. Override to support
+/// hibernation without losing the view.
+/// \result The view state.
+/// \sa Workspace::setHibernationTimeout
+//-----------------------------------------------------------------------------
+QByteArray
+WorkspaceItem::saveViewState() const
+{
+    return QByteArray();
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::restoreViewState()
+//
+/// Restore the view state saved by saveViewState() when the item was
+/// hibernated.
+/// \param inState The view state.
+//-----------------------------------------------------------------------------
+void
+WorkspaceItem::restoreViewState(const QByteArray& inState)
+{
+    Q_UNUSED(inState);
+}
+
 void
 WorkspaceItem::setCentralWidget(QWidget* w)
 {
@@ -353,7 +392,152 @@ WorkspaceItem::getOwningPanel() const
 void
 WorkspaceItem::setOwningPanel(WorkspacePanel* panel)
 {
+    if (panel == mOwningPanel)
+        return;
+
+    if (mOwningPanel != NULL) {
+        disconnect(mOwningPanel, SIGNAL(exposureChanged(WorkspacePanel::Exposure)),
+                   this, SIGNAL(exposureChanged(WorkspacePanel::Exposure)));
+
+        // The progress of a running preparation moves with the item
+        if (isPreparing())
+            mOwningPanel->stopProgress();
+    }
+
     mOwningPanel = panel;
+
+    if (mOwningPanel != NULL) {
+        connect(mOwningPanel, SIGNAL(exposureChanged(WorkspacePanel::Exposure)),
+                this, SIGNAL(exposureChanged(WorkspacePanel::Exposure)));
+        Q_EMIT exposureChanged(mOwningPanel->exposure());
+
+        if (isPreparing())
+            mOwningPanel->startProgress();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::startPreparation
+//
+/// Run the preparation of the item. The Workspace calls this once the
+/// item has been placed in a panel. If prepare() returns a running future
+/// the owning panel shows its progress indicator until the future
+/// finishes, and prepared() is then called on the GUI thread.
+/// \sa prepare, prepared
+//-----------------------------------------------------------------------------
+void
+WorkspaceItem::startPreparation()
+{
+    if (mPrepareWatcher != NULL)
+        return;
+
+    const QFuture<void> theFuture = prepare();
+    if (theFuture.isFinished()) {
+        prepared(!theFuture.isCanceled());
+        return;
+    }
+
+    mPrepareWatcher = new QFutureWatcher<void>(this);
+    connect(mPrepareWatcher, SIGNAL(finished()), this, SLOT(onPreparationFinished()));
+
+    if (mOwningPanel != NULL)
+        mOwningPanel->startProgress();
+
+    mPrepareWatcher->setFuture(theFuture);
+}
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::cancelPreparation
+//
+/// Cancel a running preparation and wait for the work to stop. The
+/// progress indicator of the owning panel is stopped, and prepared() is
+/// not called. A subclass that overrides prepare() must call this in its
+/// own destructor, while the members the work uses are still alive.
+/// \sa startPreparation, prepare
+//-----------------------------------------------------------------------------
+void
+WorkspaceItem::cancelPreparation()
+{
+    if (mPrepareWatcher == NULL)
+        return;
+
+    QFutureWatcher<void>* theWatcher = mPrepareWatcher;
+    mPrepareWatcher = NULL;
+
+    theWatcher->disconnect(this);
+    theWatcher->cancel();
+    theWatcher->waitForFinished();
+    delete theWatcher;
+
+    if (mOwningPanel != NULL)
+        mOwningPanel->stopProgress();
+}
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::prepare
+//
+/// Override to do heavy non-GUI work, such as opening data files or
+/// building models, off the GUI thread. Return the future of the work,
+/// typically from QtConcurrent::run. The work must not touch widgets.
+/// The default has nothing to prepare and returns a finished future.
+/// Subclasses that override this must call cancelPreparation() in their
+/// destructor.
+/// \result The future of the preparation.
+//-----------------------------------------------------------------------------
+QFuture<void>
+WorkspaceItem::prepare()
+{
+    // A default constructed future reports itself as canceled
+    QFutureInterface<void> theInterface;
+    theInterface.reportStarted();
+    theInterface.reportFinished();
+    return theInterface.future();
+}
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::prepared
+//
+/// Override to populate the widgets once the preparation is done. Called
+/// on the GUI thread, also when there was nothing to prepare.
+/// \param inSucceeded False if the preparation was canceled.
+//-----------------------------------------------------------------------------
+void
+WorkspaceItem::prepared(bool inSucceeded)
+{
+    Q_UNUSED(inSucceeded);
+}
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::onPreparationFinished [slot]
+//-----------------------------------------------------------------------------
+void
+WorkspaceItem::onPreparationFinished()
+{
+    Q_ASSERT(mPrepareWatcher != NULL);
+
+    const bool succeeded = !mPrepareWatcher->isCanceled();
+    mPrepareWatcher->deleteLater();
+    mPrepareWatcher = NULL;
+
+    if (mOwningPanel != NULL)
+        mOwningPanel->stopProgress();
+
+    prepared(succeeded);
+}
+
+//-----------------------------------------------------------------------------
+// WorkspaceItem::exposure
+//
+/// Return the exposure state of the panel hosting this item. Items that
+/// are not hosted by a panel are considered to be in the background.
+//-----------------------------------------------------------------------------
+WorkspacePanel::Exposure
+WorkspaceItem::exposure() const
+{
+    if (mOwningPanel == NULL)
+        return WorkspacePanel::ExposureBackground;
+
+    return mOwningPanel->exposure();
 }
 
 //=============================================================================
@@ -22,16 +22,20 @@ THE SOFTWARE.
 #define WORKSPACEITEM_HAS_BEEN_INCLUDED
 
 // Qt
+#include <QByteArray>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QWidget>
 #include <QtPlugin>
 
+// Local
+#include "WorkspacePanel.h"
+
 // Forward declarations
 class QAction;
 class QLayout;
 class QMenu;
 
-class WorkspacePanel;
-
 namespace workspace {
 
 // Forward declarations
@@ -89,6 +93,13 @@ public:
 
     virtual Qt::DockWidgetArea getDockPlacementHint() const;
 
+    virtual QByteArray saveViewState() const;
+    virtual void restoreViewState(const QByteArray& inState);
+
+    void startPreparation();
+    void cancelPreparation();
+    bool isPreparing() const;
+
     // HACKY
     void setFloating(bool f) { mFloating = f; }
     bool floating() const { return mFloating; }
@@ -96,6 +107,8 @@ public:
     WorkspacePanel* getOwningPanel() const;
     void setOwningPanel(WorkspacePanel* panel);
 
+    WorkspacePanel::Exposure exposure() const;
+
     /// Signal names to be used for method invocation
     static const char* Copy;
     static const char* Cut;
@@ -110,6 +123,10 @@ public:
 Q_SIGNALS:
     void titleSet(const QString& inTitle);
 
+    /// Emitted when the owning panel becomes visible, occluded, moves to
+    /// the background or is suspended. Use it to throttle expensive work.
+    void exposureChanged(WorkspacePanel::Exposure inExposure);
+
 public Q_SLOTS:
     void setTitle(const QString& inTitle);
 
@@ -139,8 +156,12 @@ public Q_SLOTS:
     
 private Q_SLOTS:
     void showMe(bool inShow);
+    void onPreparationFinished();
 
 protected:
+    virtual QFuture<void> prepare();
+    virtual void prepared(bool inSucceeded);
+
     virtual void showEvent(QShowEvent* inEvent);
     virtual void hideEvent(QHideEvent* inEvent);
     virtual void changeEvent(QEvent* inEvent);
@@ -156,10 +177,12 @@ private:
     QLayout* mLayout;
     QWidget* mCentralWidget;
     WorkspacePanel* mOwningPanel;
+    QFutureWatcher<void>* mPrepareWatcher;
 };
 
 inline WorkspaceItem::MenuMergeType WorkspaceItem::getMenuMergeType() const { return mMenuMergeType; }
 inline const WorkspaceItem::MenuList& WorkspaceItem::getMenuList() const { return mMenuList; }
+inline bool WorkspaceItem::isPreparing() const { return mPrepareWatcher != NULL; }
 
 
 //=============================================================================
@@ -168,6 +191,9 @@ inline const WorkspaceItem::MenuList& WorkspaceItem::getMenuList() const { retur
 /*! Provides a plugin interface to the Workspace.
  *  You can use this mechanism to create plugins that will add
  *  user interface elements to the Workspace.
+ *  Plugins should declare a className, menuTitle and icon in their
+ *  Q_PLUGIN_METADATA so the Workspace can offer them without loading
+ *  the library. See PluginCatalog.
 */	
  class WorkspacePlugin : public QObject
 {
@@ -162,13 +162,15 @@ TabBarDragger::eventFilter(QObject* watched, QEvent* event)
 		{
 			if (mDragState != NULL) {
 				
-				if (mDragState->dragging && mouseEvent->button() == Qt::LeftButton) {
-					endDrag();
+				if (mDragState->dragging) {
+					// Releasing any other button cancels the drag, which
+					// also drops the backgrounds grabbed during it
+					endDrag(mouseEvent->button() != Qt::LeftButton);
 					dragWidget->setCursor(Qt::ArrowCursor);
+				} else {
+					delete mDragState;
+					mDragState = NULL;
 				}
-				
-				delete mDragState;
-				mDragState = NULL;
 
 				// Don't consume the event. We want the WorkspaceTabBar to clean
 				// up and handle tab drag positioning.
@@ -591,6 +593,100 @@ WorkspaceLayout::addWidgetAtLocation(QWidget* inWidget,
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspaceLayout::getPanelGroupMinimumSize()
+//
+/// Get the minimum size the grid gives a panel group holding the panels.
+/// This is what both the live layout and solvePanelGroups() solve with,
+/// so geometry solved ahead of time matches the live layout.
+/// \param inPanels The panels of the group.
+/// \result The minimum size of the group.
+//-----------------------------------------------------------------------------
+QSize
+WorkspaceLayout::getPanelGroupMinimumSize(const QList<WorkspacePanel*>& inPanels)
+{
+    QSize theSize(0, 0);
+    Q_FOREACH(WorkspacePanel* thePanel, inPanels)
+        theSize = theSize.expandedTo(thePanel->sizeHint());
+
+    return theSize;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceLayout::getItemMinimumSize()
+//
+/// Panel groups are solved with getPanelGroupMinimumSize() instead of
+/// their size hint.
+/// \param inWidget The managed widget.
+/// \result The minimum size of the item.
+//-----------------------------------------------------------------------------
+QSize
+WorkspaceLayout::getItemMinimumSize(QWidget* inWidget) const
+{
+    WorkspacePanelGroup* theGroup = qobject_cast<WorkspacePanelGroup*>(inWidget);
+    if (theGroup == NULL)
+        return DynamicGridLayout::getItemMinimumSize(inWidget);
+
+    QList<WorkspacePanel*> thePanels;
+    for (int index = 0; index < theGroup->count(); ++index) {
+        WorkspacePanel* thePanel = qobject_cast<WorkspacePanel*>(theGroup->widget(index));
+        if (thePanel != NULL)
+            thePanels.push_back(thePanel);
+    }
+
+    return getPanelGroupMinimumSize(thePanels);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceLayout::solvePanelGroups()
+//
+/// Solve the geometry of a set of panel groups without creating any
+/// widgets. The groups get the same constraints addWidgetAtLocation()
+/// would give them. The minimum sizes have to be worked out beforehand
+/// with getPanelGroupMinimumSize(), on the thread that owns the panels.
+/// This does not touch any widgets and may be called from a worker
+/// thread.
+/// \param inCells The grid cells of the groups as x, y, width and height.
+/// \param inMinimumSizes The minimum size of each group, in the order of
+/// inCells.
+/// \param inSize The size of the area the groups are laid out in.
+/// \param outBounds The bounds of each group, in the order of inCells.
+//-----------------------------------------------------------------------------
+void
+WorkspaceLayout::solvePanelGroups(const QList<QRect>& inCells,
+                                  const QList<QSize>& inMinimumSizes,
+                                  const QSize& inSize,
+                                  QList<QRect>& outBounds)
+{
+    Q_ASSERT(inCells.size() == inMinimumSizes.size());
+
+    QList<DynamicGridConstraints*> theItems;
+    for (int index = 0; index < inCells.size(); ++index) {
+        const QRect& theCell = inCells.at(index);
+        DynamicGridConstraints* theConstraints = new DynamicGridConstraints();
+        theConstraints->setFill(DynamicGridConstraints::BOTH);
+        theConstraints->setWeightX(kDefaultWeight);
+        theConstraints->setWeightY(kDefaultWeight);
+        theConstraints->setInsets(Insets(kInsetAmount,
+                                         kInsetAmount,
+                                         kInsetAmount,
+                                         kInsetAmount));
+        theConstraints->setX(theCell.x());
+        theConstraints->setY(theCell.y());
+        theConstraints->setWidth(theCell.width());
+        theConstraints->setHeight(theCell.height());
+        theConstraints->setMinimumSize(inMinimumSizes.at(index));
+        theItems.push_back(theConstraints);
+    }
+
+    DynamicGridLayout::solveLayout(theItems, Insets(), inSize, outBounds);
+
+    qDeleteAll(theItems);
+}
+
+
 //-----------------------------------------------------------------------------
 // WorkspaceLayout::insertWidget()
 //
@@ -1065,6 +1161,9 @@ WorkspaceLayout::hover(QWidget* inWidget, const QPoint& inPoint)
 void
 WorkspaceLayout::endHover(QWidget* inWidget)
 {    
+    // The drag is over, the grabbed backgrounds are of no further use
+    mDropIndicator->clearSnapshotCache();
+
     // Figure out what was passed in
     WorkspacePanel* inPanel = qobject_cast<WorkspacePanel*>(inWidget);
     WorkspacePanelGroup* inGroup = qobject_cast<WorkspacePanelGroup*>(inWidget);
@@ -1158,8 +1257,10 @@ WorkspaceLayout::endHover(QWidget* inWidget)
                         // make the position change animation appear correct.
                         inPanel->move(sourcePanelGroup->pos());
                         
-                        // The panel is now parentless until inserted below.
-                        inPanel->setParent(NULL);
+                        // Park the panel in the area until inserted below.
+                        // Making it parentless would give it a native
+                        // window of its own for no reason.
+                        inPanel->setParent(parentWidget());
                     }
                 }
                 break;
@@ -77,6 +77,16 @@ public:
     QSize itemSize(QWidget* inWidget);
 
     WorkspacePanelGroup* findPanelGroup(WorkspacePanel* inPanel) const;
+    WorkspacePanelDropIndicator* getDropIndicator() const;
+
+    static QSize getPanelGroupMinimumSize(const QList<WorkspacePanel*>& inPanels);
+    static void solvePanelGroups(const QList<QRect>& inCells,
+                                 const QList<QSize>& inMinimumSizes,
+                                 const QSize& inSize,
+                                 QList<QRect>& outBounds);
+
+protected:
+    virtual QSize getItemMinimumSize(QWidget* inWidget) const;
 
 private:
     void insertPanelGroup(WorkspacePanelGroup* inTargetGroup,
@@ -110,6 +120,8 @@ private:
 
 };
 
+inline WorkspacePanelDropIndicator* WorkspaceLayout::getDropIndicator() const { return mDropIndicator; }
+
 #endif // !WORKSPACE_LAYOUT_HAS_BEEN_INCLUDED
 
 
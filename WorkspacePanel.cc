@@ -27,6 +27,8 @@ THE SOFTWARE.
 #include <QBitmap>
 #include <QCursor>
 #include <QEvent>
+#include <QGuiApplication>
+#include <QKeyEvent>
 #include <QMenu>
 #include <QMouseEvent>
 #include <QPainter>
@@ -36,7 +38,7 @@ THE SOFTWARE.
 #include <QToolButton>
 #include <QtDebug>
 
-// Needed for window title drag key modifier detection
+// Needed for window title drag mouse button detection
 #ifndef Q_WS_MAC
 #include <QX11Info>
 #include <X11/Xlib.h>
@@ -45,11 +47,21 @@ THE SOFTWARE.
 #endif
 
 // Local
+#include "FloatingWindowPool.h"
+#include "TaskScheduler.h"
 #include "WorkspaceArea.h"
+#include "WorkspaceItem.h"
 #include "WorkspaceLayout.h"
+#include "WorkspacePanelGroup.h"
 #include "WorkspaceTabBar.h"
 #include "WorkspaceUtils.h"
 
+// Namespaces
+using namespace workspace;
+
+// Constants
+static const int kReleaseCheckDelay = 150;
+
 namespace {
 
 QString
@@ -101,106 +113,6 @@ qt_setWindowTitle_helperHelper(const QString &title, const QWidget *widget)
 }
 
 
-//-----------------------------------------------------------------------------
-// translateModifiers
-// 
-/// Translate X11 modifier to Qt modifier
-/// \result The translated modifier
-/// \param inState The X11 state.
-//-----------------------------------------------------------------------------
-#ifdef Q_WS_MAC
-static Qt::KeyboardModifiers 
-translateModifiers(UInt32 inState)
-{
-    bool shiftKey, ctrlKey, altKey, metaKey;
-    shiftKey = inState & ::shiftKey;
-    ctrlKey = inState & ::controlKey;
-    altKey = inState & ::optionKey;
-    metaKey = inState & ::cmdKey;
-
-#if 0    
-    qDebug() << shiftKey;
-    qDebug() << ctrlKey;
-    qDebug() << altKey;
-    qDebug() << metaKey;
-    qDebug() << "\n\n";
-#endif
-    
-    Qt::KeyboardModifiers result = 0;
-    
-    if (shiftKey)
-        result |= Qt::ShiftModifier;
-        
-    if (ctrlKey)
-        result |= Qt::ControlModifier;
-
-    if (altKey)
-        result |= Qt::AltModifier;
-
-    if (metaKey)
-        result |= Qt::MetaModifier;
-
-    return result;
-}
-#else
-static Qt::KeyboardModifiers 
-translateModifiers(int inState)
-{
-    Qt::KeyboardModifiers result = 0;
-    
-    if (inState & ShiftMask)
-        result |= Qt::ShiftModifier;
-        
-    if (inState & ControlMask)
-        result |= Qt::ControlModifier;
-
-    if (inState & Mod1Mask)
-        result |= Qt::AltModifier;
-
-    if (inState & Mod2Mask)
-        result |= Qt::MetaModifier;
-
-    return result;
-}
-#endif
-
-
-//-----------------------------------------------------------------------------
-// getCurrentKeyboardModifiers
-// 
-/// Utility to get keyboard state outside of Qt event loop.
-/// \result The current keyboard modifiers
-//-----------------------------------------------------------------------------
-static Qt::KeyboardModifiers 
-getCurrentKeyboardModifiers()
-{
-#ifndef Q_WS_MAC    
-    Window root;
-    Window child;
-    int root_x, root_y, win_x, win_y;
-    uint keyState;
-
-    for (int index = 0; index < ScreenCount(QX11Info::display()); ++index) {
-        if (XQueryPointer(QX11Info::display(), 
-                          QX11Info::appRootWindow(index), 
-                          &root, 
-                          &child, 
-                          &root_x, 
-                          &root_y, 
-                          &win_x, 
-                          &win_y, 
-                          &keyState)) {
-            return translateModifiers(keyState & 0x00ff);
-        }
-    }
-#else
-    return translateModifiers(::GetCurrentKeyModifiers());
-#endif
-
-    return 0;
-}
-
-
 #ifndef Q_WS_MAC
 //-----------------------------------------------------------------------------
 // isMouseButtonDown()
@@ -520,7 +432,11 @@ WorkspacePanel::WorkspacePanel(const QString& inTitle,
                 | WorkspacePanel::DockWidgetFloatable)
     ,   mAllowedAreas(Qt::AllDockWidgetAreas)
     ,   mToggleViewAction(NULL)
-    ,   mTimerId(-1)
+    ,   mDragTracking(false)
+    ,   mDragCtrl(false)
+    ,   mReleaseCheckTaskId(-1)
+    ,   mExposure(ExposureBackground)
+    ,   mProgressCount(0)
 {
     // QCursor is lately very finicky about the bitmaps you pass it.
     // They MUST be monochromatic. Convert them here just to be sure.
@@ -537,9 +453,21 @@ WorkspacePanel::WorkspacePanel(const QString& inTitle,
 WorkspacePanel::~WorkspacePanel()
 {
     // Stop the mousewatcher
-    if (mTimerId != -1) {
-        killTimer(mTimerId);
-        mTimerId = -1;
+    TaskScheduler::instance()->cancel(mReleaseCheckTaskId);
+    if (mDragTracking)
+        qApp->removeEventFilter(this);
+
+    // The item is deleted with the panel, and may stop its progress on the
+    // way. Let go of it while this is still a whole panel.
+    WorkspaceItem* theItem = qobject_cast<WorkspaceItem*>(widget());
+    if (theItem != NULL && theItem->getOwningPanel() == this)
+        theItem->setOwningPanel(NULL);
+
+    // The frame may be half destroyed already, when it is what deletes
+    // the panel, so it is neither reparented nor returned to the pool
+    if (!mFloatingFrame.isNull()) {
+        mFloatingFrame->removeEventFilter(this);
+        mFloatingFrame->deleteLater();
     }
 }
 
@@ -622,6 +550,8 @@ WorkspacePanel::changeEvent(QEvent* event)
         case QEvent::WindowTitleChange:
             mFixedWindowTitle = qt_setWindowTitle_helperHelper(windowTitle(), this);
             mToggleViewAction->setText(mFixedWindowTitle);
+            if (!mFloatingFrame.isNull())
+                mFloatingFrame->setWindowTitle(windowTitle());
             break;
 
         default:
@@ -649,11 +579,13 @@ WorkspacePanel::event(QEvent *event)
             
         mToggleViewAction->setChecked(false);
         Q_EMIT visibilityChanged(false);
+        scheduleExposureUpdate();
         break;
 
     case QEvent::Show:
         mToggleViewAction->setChecked(true);
         Q_EMIT visibilityChanged(geometry().right() >= 0 && geometry().bottom() >= 0);
+        scheduleExposureUpdate();
         break;
 
     case QEvent::ZOrderChange: {
@@ -672,12 +604,18 @@ WorkspacePanel::event(QEvent *event)
     case QEvent::Resize:
         if (isFloating() && layout != NULL)
             mUndockedGeometry = geometry();
+        if (isWindow())
+            scheduleExposureUpdate();
         break;
 
     case QEvent::Move:
     {       
-		if (isFloating())
+		if (isFloating() && mFloatingFrame.isNull())
             titleBarDragEvent(static_cast<QMoveEvent*>(event));
+
+        // A floating panel moving around may cover or uncover docked panels
+        if (isWindow())
+            scheduleExposureUpdate();
     }
     break;        
 
@@ -687,6 +625,18 @@ WorkspacePanel::event(QEvent *event)
     }
     break;
 
+    case QEvent::NonClientAreaMouseButtonRelease:
+        // Some platforms do report the end of a title bar drag
+        if (mDragTracking)
+            endDragTracking();
+        break;
+
+    case QEvent::ParentChange:
+        // Docked by something that simply took the panel out of its frame
+        if (!mFloatingFrame.isNull() && parentWidget() != mFloatingFrame)
+            releaseFloatingFrame();
+        break;
+
     default:
         break;
     }
@@ -695,6 +645,90 @@ WorkspacePanel::event(QEvent *event)
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspacePanel::eventFilter
+//
+/// Watch the floating frame hosting the panel. The frame is the window
+/// the user drags around, so its events stand in for our own. While a
+/// title bar drag is tracked, every event of the application comes by
+/// here, and the first button release ends the drag.
+//-----------------------------------------------------------------------------
+bool
+WorkspacePanel::eventFilter(QObject* inObject, QEvent* inEvent)
+{
+    // Filtering the whole application while a title bar drag is tracked
+    if (mDragTracking) {
+        switch (inEvent->type()) {
+            case QEvent::MouseButtonRelease:
+            case QEvent::NonClientAreaMouseButtonRelease:
+                endDragTracking();
+                break;
+
+            case QEvent::MouseMove:
+                if (static_cast<QMouseEvent*>(inEvent)->buttons() == Qt::NoButton)
+                    endDragTracking();
+                break;
+
+            case QEvent::KeyPress:
+            case QEvent::KeyRelease:
+                // The modifier decides whether the workspace hover shows
+                if (static_cast<QKeyEvent*>(inEvent)->key() == Qt::Key_Control)
+                    updateDragTracking();
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (inObject != mFloatingFrame.data())
+        return QFrame::eventFilter(inObject, inEvent);
+
+    switch (inEvent->type()) {
+        case QEvent::Move:
+            titleBarDragEvent(static_cast<QMoveEvent*>(inEvent));
+            scheduleExposureUpdate();
+            break;
+
+        case QEvent::Resize:
+            mUndockedGeometry = mFloatingFrame->geometry();
+            scheduleExposureUpdate();
+            break;
+
+        case QEvent::Show:
+        case QEvent::Hide:
+            scheduleExposureUpdate();
+            break;
+
+        case QEvent::Close:
+            // Closing the frame closes the panel
+            hide();
+            break;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanel::setVisible
+//
+/// Show or hide the panel, along with its floating frame if it has one.
+/// \param inVisible The visibility.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanel::setVisible(bool inVisible)
+{
+    QFrame::setVisible(inVisible);
+
+    if (!mFloatingFrame.isNull())
+        mFloatingFrame->setVisible(inVisible);
+}
+
+
 /*! \reimp */
 void
 WorkspacePanel::paintEvent(QPaintEvent* paintEvent)
@@ -826,73 +860,132 @@ QSize WorkspacePanelItem::sizeHint() const
 
 
 //-----------------------------------------------------------------------------
-// WorkspacePanel::titleBarDragEvent
+// WorkspacePanel::getDragLayout
+//
+/// \result The layout a floating panel can be docked into, or NULL.
+//-----------------------------------------------------------------------------
+WorkspaceLayout*
+WorkspacePanel::getDragLayout() const
+{
+    QWidget* theWidget = !mFloatingFrame.isNull() ? mFloatingFrame->parentWidget() : parentWidget();
+    if (theWidget == NULL)
+        return NULL;
+
+    return qobject_cast<WorkspaceLayout*>(theWidget->layout());
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanel::updateDragTracking
+//
+/// Update the workspace hover for the current pointer position and
+/// keyboard state. Nothing is done unless either has changed.
 //-----------------------------------------------------------------------------
 void
-WorkspacePanel::timerEvent(QTimerEvent* inEvent)
+WorkspacePanel::updateDragTracking()
 {
-    Q_UNUSED(inEvent);
+    WorkspaceLayout* theLayout = getDragLayout();
+    if (theLayout == NULL)
+        return;
+
+    const bool ctrlDrag = QGuiApplication::queryKeyboardModifiers() & Qt::ControlModifier;
+    const QPoint thePos = QCursor::pos();
+    if (ctrlDrag == mDragCtrl && thePos == mDragPos)
+        return;
+
+    mDragCtrl = ctrlDrag;
+    mDragPos = thePos;
+
+    if (ctrlDrag && isOverWorkspace()) {
+        // Show and update the workspace hover 
+        // while the key is pressed.
+        theLayout->hover(this, thePos);
+        mHover = true;
+    } else if (mHover) {
+        // Hide the workspace hover indicator when the
+        // key is released or the pointer leaves the workspace
+        theLayout->endHover();
+        mHover = false;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanel::endDragTracking
+//
+/// The title bar drag is over. Redock into the workspace if the panel
+/// was dropped on the hover indicator.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanel::endDragTracking()
+{
+    TaskScheduler::instance()->cancel(mReleaseCheckTaskId);
+    mReleaseCheckTaskId = -1;
+    if (mDragTracking)
+        qApp->removeEventFilter(this);
+    mDragTracking = false;
+    mDragPos = QPoint();
+    mDragCtrl = false;
+
+    if (!mHover)
+        return;
 
-    // Get the layout
-    QWidget* theWidget = parentWidget();
-    WorkspaceLayout* theLayout = NULL;
-    if (theWidget != NULL)
-        theLayout = qobject_cast<WorkspaceLayout*>(theWidget->layout());
+    mHover = false;
 
+    WorkspaceLayout* theLayout = getDragLayout();
     if (theLayout == NULL)
         return;
 
-    // Get the mouse button state
-    const bool ctrlDrag = getCurrentKeyboardModifiers() & Qt::ControlModifier;
+    if (isOverWorkspace())
+        theLayout->endHover(this);
+    else
+        theLayout->endHover();
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanel::onReleaseCheck [slot]
+//
+/// The window manager does not tell us when a title bar drag ends, and
+/// the release only reaches us as an event when the pointer is over one
+/// of our windows. So once the moves have stopped for a moment, check the
+/// mouse button a single time for a release we never saw. If the button
+/// is still down, the next move arms the check again.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanel::onReleaseCheck()
+{
+    mReleaseCheckTaskId = -1;
+
+    if (!mDragTracking)
+        return;
+
 #ifdef Q_WS_MAC
-    if (!::GetCurrentEventButtonState() & kEventMouseButtonPrimary) {
+    const bool buttonDown = ::GetCurrentEventButtonState() & kEventMouseButtonPrimary;
 #else    
-    if (!isMouseButtonDown(Button1Mask)) {
+    const bool buttonDown = isMouseButtonDown(Button1Mask);
 #endif    
-        // Stop the mouse watcher
-        killTimer(mTimerId);
-        mTimerId = -1;
-
-        // Check and see if we need to redock into the workspace.
-        if (mHover && isOverWorkspace()) {
-            mHover = false;
-            theLayout->endHover(this);
-        }
-    } else {           
-        if (ctrlDrag) {
-            // Show and update the workspace hover 
-            // while the key is pressed.
-            theLayout->hover(this, QCursor::pos());
-            mHover = true;
-        } else {
-            if (mHover) {
-                // Hide the workspace hover indicator
-                // when the control key is released   
-                theLayout->endHover();
-                mHover = false;
-            }                
-        }
-    }         
+
+    if (buttonDown) {
+        // The modifier may have changed while the pointer was resting
+        updateDragTracking();
+    } else {
+        endDragTracking();
+    }
 }
 
 
 //-----------------------------------------------------------------------------
 // WorkspacePanel::startProgress
 //
-/// Activate the progress indicator.
+/// Activate the progress indicator on the tab of the panel. Calls nest;
+/// the indicator stays on until stopProgress has been called as often.
 //-----------------------------------------------------------------------------
 void
 WorkspacePanel::startProgress()
 {
-/*
-    TODO gragan: Hook this up
-	WorkspaceArea* theArea = qobject_cast<WorkspaceArea*>(parent());
-	Q_ASSERT(theArea != NULL);
-	
-	WorkspaceLayout* theLayout =
-		qobject_cast<WorkspaceLayout*>(theArea->layout());
-	Q_ASSERT(theLayout != NULL);
-*/
+    if (mProgressCount++ == 0)
+        showProgress(true);
 }
 
 
@@ -904,11 +997,32 @@ WorkspacePanel::startProgress()
 void
 WorkspacePanel::stopProgress()
 {
-/*
-    TODO gragan: Hook this up
-	WorkspaceArea* theArea = qobject_cast<WorkspaceArea*>(parent());
-	Q_ASSERT(theArea != NULL);
-*/
+    if (mProgressCount == 0)
+        return;
+
+    if (--mProgressCount == 0)
+        showProgress(false);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanel::showProgress
+//
+/// Show or hide the indicator on the tab of the panel. A panel that is
+/// not in a panel group gets its indicator when it is added to one.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanel::showProgress(bool inShow)
+{
+    WorkspacePanelGroup* theGroup = WorkspaceUtils::findParent<WorkspacePanelGroup>(parent());
+    if (theGroup == NULL)
+        return;
+
+    const int theIndex = theGroup->indexOf(this);
+    if (inShow)
+        theGroup->getTabBar()->startProgress(theIndex);
+    else
+        theGroup->getTabBar()->stopProgress(theIndex);
 }
 
 
@@ -947,11 +1061,7 @@ bool
 WorkspacePanel::isOverWorkspace() const
 {
     // Get the layout    
-    QWidget* theWidget = parentWidget();
-    WorkspaceLayout* theLayout = NULL;
-    if (theWidget != NULL)
-        theLayout = qobject_cast<WorkspaceLayout*>(theWidget->layout());
-
+    WorkspaceLayout* theLayout = getDragLayout();
     if (theLayout == NULL)
         return false;
         
@@ -972,56 +1082,80 @@ WorkspacePanel::isOverWorkspace() const
 
 //-----------------------------------------------------------------------------
 // WorkspacePanel::titleBarDragEvent
+//
+/// Track a title bar drag of the floating panel. The window manager is
+/// moving the window, so we only get move events, and use those to
+/// update the workspace hover.
 //-----------------------------------------------------------------------------
 void
 WorkspacePanel::titleBarDragEvent(QMoveEvent* inEvent)
 {
     Q_UNUSED(inEvent);
-  
-    // Start observing the mouse button and keyboard state
-    // during the titlebar drag. We can't use normal Qt 
-    // event checking for this, as the window manager is
-    // controlling the window.
-    if (mTimerId == -1)
-        mTimerId = startTimer(25);
-
-    const bool ctrlDrag = getCurrentKeyboardModifiers() & Qt::ControlModifier;
-
-    if (ctrlDrag && !isOverWorkspace()) {
-        QWidget* theWidget = parentWidget();
-        WorkspaceLayout* theLayout = NULL;
-        if (theWidget != NULL) {
-            theLayout = qobject_cast<WorkspaceLayout*>(theWidget->layout());
-            if (theLayout != NULL) {
-                mHover = false;
-                theLayout->endHover();
-            }
-        }
+
+    // Any release the application sees ends the drag
+    if (!mDragTracking) {
+        mDragTracking = true;
+        qApp->installEventFilter(this);
     }
+
+    updateDragTracking();
+
+    // The release normally ends the drag through eventFilter(). Look at
+    // the button only if no further move follows, in case the release
+    // went to the window manager.
+    TaskScheduler::instance()->cancel(mReleaseCheckTaskId);
+    mReleaseCheckTaskId = TaskScheduler::instance()->schedule(this, 
+                                                              SLOT(onReleaseCheck()), 
+                                                              kReleaseCheckDelay);
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspacePanel::setWindowState
+//
+/// Float or dock the panel. Inside a WorkspaceArea, a floating panel is
+/// moved into a frame from the area's FloatingWindowPool, so no native
+/// window is created or destroyed on the way.
+/// \param inFloating True to float the panel.
+//-----------------------------------------------------------------------------
 void 
 WorkspacePanel::setWindowState(bool inFloating)
 {
     const bool wasFloating = isFloating();
     const bool hidden = isHidden();
 
-    Qt::WindowFlags flags = inFloating ? Qt::Window : Qt::Widget;
-
-    // Calling setWindowFlags with the Qt::Window flag clear, when
-    // previously it was set, causes SEVERE flashing on X11. The
-    // entire desktop flashes. The only workaround I've found is
-    // to use Qt::Tool instead of Qt::Window. This goes against
-    // our design, which says that large panels NOT be always on
-    // top of the main window.
-    // This problem appears to be related to the window manager. It
-    // occurs under metacity, but not kwin, for example.
-    setWindowFlags(flags);
-
-    if (!hidden) {
-        QMetaObject::invokeMethod(this, "show", Qt::QueuedConnection);
-        QMetaObject::invokeMethod(this, "raise", Qt::QueuedConnection);
+    WorkspaceArea* theArea = WorkspaceUtils::findParent<WorkspaceArea>(parent());
+    if (theArea != NULL && !isWindow()) {
+        if (inFloating && mFloatingFrame.isNull()) {
+            mFloatingFrame = theArea->getFloatingWindowPool()->acquire(this);
+            mFloatingFrame->installEventFilter(this);
+        } else if (!inFloating && !mFloatingFrame.isNull()) {
+            releaseFloatingFrame();
+        }
+
+        // Reparenting hid the panel
+        if (!hidden) {
+            show();
+            if (!mFloatingFrame.isNull())
+                mFloatingFrame->raise();
+        }
+    } else {
+        Qt::WindowFlags flags = inFloating ? Qt::Window : Qt::Widget;
+
+        // Calling setWindowFlags with the Qt::Window flag clear, when
+        // previously it was set, causes SEVERE flashing on X11. The
+        // entire desktop flashes. The only workaround I've found is
+        // to use Qt::Tool instead of Qt::Window. This goes against
+        // our design, which says that large panels NOT be always on
+        // top of the main window.
+        // This problem appears to be related to the window manager. It
+        // occurs under metacity, but not kwin, for example.
+        setWindowFlags(flags);
+
+        if (!hidden) {
+            QMetaObject::invokeMethod(this, "show", Qt::QueuedConnection);
+            QMetaObject::invokeMethod(this, "raise", Qt::QueuedConnection);
+        }
     }
 
     if (inFloating != wasFloating) {
@@ -1043,17 +1177,84 @@ WorkspacePanel::setWindowState(bool inFloating)
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspacePanel::releaseFloatingFrame
+//
+/// Move the panel out of its floating frame, back into the area that
+/// owns the frame, and return the frame to the pool.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanel::releaseFloatingFrame()
+{
+    QWidget* theFrame = mFloatingFrame;
+    Q_ASSERT(theFrame != NULL);
+
+    // Cleared first so the reparenting below is not taken for a dock
+    mFloatingFrame.clear();
+    theFrame->removeEventFilter(this);
+
+    QWidget* theArea = theFrame->parentWidget();
+    if (parentWidget() == theFrame)
+        setParent(theArea);
+
+    WorkspaceArea* workspaceArea = qobject_cast<WorkspaceArea*>(theArea);
+    if (workspaceArea != NULL)
+        workspaceArea->getFloatingWindowPool()->release(theFrame);
+    else
+        theFrame->deleteLater();
+}
+
+
 //-----------------------------------------------------------------------------
 // WorkspacePanel::setActive
 // 
-/// Set the panel to the active state.
+/// Set the panel to the active state. Only the frame, which shows the
+/// state, is repainted, not the content of the panel.
 /// \param inActive The active state to set.
 //-----------------------------------------------------------------------------
 void
 WorkspacePanel::setActive(bool inActive) 
 { 
+    if (inActive == mActive)
+        return;
+
     mActive = inActive; 
-    update();
+
+    const QRect outline = rect();
+    update(QRegion(outline) - QRegion(outline.adjusted(1, 1, -1, -1)));
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanel::setExposure
+// 
+/// Set the exposure state of the panel. This is normally only called by
+/// the WorkspaceArea, which computes the state for all of its panels.
+/// \param inExposure The new exposure state.
+/// \sa exposureChanged
+//-----------------------------------------------------------------------------
+void
+WorkspacePanel::setExposure(Exposure inExposure)
+{
+    if (inExposure == mExposure)
+        return;
+
+    mExposure = inExposure;
+    Q_EMIT exposureChanged(mExposure);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanel::scheduleExposureUpdate
+// 
+/// Ask the owning WorkspaceArea to recompute the exposure of its panels.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanel::scheduleExposureUpdate()
+{
+    WorkspaceArea* theArea = WorkspaceUtils::findParent<WorkspaceArea>(parent());
+    if (theArea != NULL)
+        theArea->scheduleExposureUpdate();
 }
 
 
@@ -1067,7 +1268,7 @@ bool
 WorkspacePanel::isFloating() const 
 { 
     // This might be a single floating window
-    if (isWindow())
+    if (isWindow() || !mFloatingFrame.isNull())
         return true;
 
     // We are part of a tab group. Get the QTabWidget
@@ -24,12 +24,14 @@ THE SOFTWARE.
 // Qt
 #include <QFrame> 
 #include <QLayout>
+#include <QPointer>
 #include <QWidget>
 
 // Forward declarations
 class QMenu;
 class QStyleOptionDockWidget;
 class QToolButton;
+class WorkspaceLayout;
 
 //=============================================================================
 // class WorkspacePanelLayout
@@ -100,6 +102,15 @@ public:
     };
     Q_DECLARE_FLAGS(DockWidgetFeatures, DockWidgetFeature)
 
+    /// How much of the panel the user can currently see. Computed by the
+    /// WorkspaceArea from the layout, tab, window and animation state.
+    enum Exposure {
+        ExposureVisible,        ///< On screen and unobstructed
+        ExposureOccluded,       ///< Docked but fully covered by floating panels
+        ExposureBackground,     ///< Hidden, e.g. a non-current tab
+        ExposureSuspended       ///< Window minimized or group mid-animation
+    };
+
     void setFeatures(DockWidgetFeatures features);
     DockWidgetFeatures features() const;
 
@@ -110,6 +121,7 @@ public:
     const QString& fixedWindowTitle() const;
 
     void setWindowState(bool floating);
+    void setVisible(bool inVisible);
     void titleBarDragEvent(QMoveEvent* inEvent);
 
     bool isAnimating() const;
@@ -119,25 +131,31 @@ public:
     
     void startProgress();
     void stopProgress();
+    bool isProgressActive() const;
 	
 	bool isActive() const;
 	void setActive(bool inActive);    
 
+    Exposure exposure() const;
+    void setExposure(Exposure inExposure);
+
 Q_SIGNALS:
     void dockLocationChanged();
     void featuresChanged(WorkspacePanel::DockWidgetFeatures features);
     void topLevelChanged(bool floating);
     void visibilityChanged(bool visible);
+    void exposureChanged(WorkspacePanel::Exposure inExposure);
 
 protected:
     void changeEvent(QEvent* event);
     bool event(QEvent* event);
+    bool eventFilter(QObject* inObject, QEvent* inEvent);
     void paintEvent(QPaintEvent* paintEvent);
-    void timerEvent(QTimerEvent* inEvent);
     void initStyleOption(QStyleOptionDockWidget* option) const;
      
 private Q_SLOTS:
     void onSignal();
+    void onReleaseCheck();
     void toggleView(bool);
     void toggleTopLevel();
 
@@ -149,6 +167,12 @@ private:
     friend class WorkspaceAreaLayoutInfo;
 
     void init(const QString& inTitle = "");
+    void scheduleExposureUpdate();
+    void showProgress(bool inShow);
+    WorkspaceLayout* getDragLayout() const;
+    void updateDragTracking();
+    void endDragTracking();
+    void releaseFloatingFrame();
 
 	bool mActive;
     bool mHover;
@@ -156,9 +180,15 @@ private:
     WorkspacePanel::DockWidgetFeatures mFeatures;
     Qt::DockWidgetAreas mAllowedAreas;
     QAction* mToggleViewAction;
-    int mTimerId;
+    bool mDragTracking;
+    bool mDragCtrl;
+    QPoint mDragPos;
+    int mReleaseCheckTaskId;
+    QPointer<QWidget> mFloatingFrame;
     QRect mUndockedGeometry;
     QString mFixedWindowTitle;
+    Exposure mExposure;
+    int mProgressCount;
 
     static int sPanelCount;
 };
@@ -168,6 +198,8 @@ inline bool WorkspacePanel::hasFeature(WorkspacePanel::DockWidgetFeature inFeatu
 inline bool WorkspacePanel::isAnimating() const { return false; }
 inline WorkspacePanel::DockWidgetFeatures WorkspacePanel::features() const { return mFeatures; }
 inline bool WorkspacePanel::isActive() const { return mActive; }
+inline WorkspacePanel::Exposure WorkspacePanel::exposure() const { return mExposure; }
+inline bool WorkspacePanel::isProgressActive() const { return mProgressCount > 0; }
 
 
 //=============================================================================
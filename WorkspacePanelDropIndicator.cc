@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include <QPainter>
 #include <QPropertyAnimation>
 #include <QPen>
+#include <QTabWidget>
 #include <QtDebug>
 
 // Local
@@ -43,8 +44,28 @@ static const int kFadeOutSpeed = 200;
 static const qreal kStartFadeValue = 0.50;
 static const qreal kEndFadeValue = 0.25;
 static const qreal kFadeOutValue = 0.10;
+
+// Memory allowed for grabbed panel backgrounds during a drag
+static const qint64 kSnapshotBudget = 32 * 1024 * 1024;
+
+// Overlay mode zone colors, matching DynamicPolygonItem
+static const QColor kZoneColor(255, 255, 255, 100);
+static const QColor kZonePrelightColor(142, 172, 255, 100);
+static const QColor kZoneOutlineColor(128, 128, 128, 100);
+}
+
+//-----------------------------------------------------------------------------
+// getPixmapBytes
+//
+/// \result The memory used by the pixels of a pixmap.
+//-----------------------------------------------------------------------------
+static qint64
+getPixmapBytes(const QPixmap& inPixmap)
+{
+    return qint64(inPixmap.width()) * inPixmap.height() * inPixmap.depth() / 8;
 }
 
+
 QDebug operator<<(QDebug dbg, WorkspacePanelDropIndicator::Area area)
 {
     switch (area){
@@ -65,7 +86,9 @@ WorkspacePanelDropIndicator::WorkspacePanelDropIndicator(QWidget* parent)
     :   QGraphicsView(parent),
         mPanel(NULL),
         mDropArea(AreaNone),
-        mCentralAreaEnabled(true),
+        mMode(ModeScene),
+        mFadeOpacity(kStartFadeValue),
+        mPrelightArea(AreaNone),
         mBackground(NULL),
         mFader(NULL),
         mNorth(NULL),
@@ -75,7 +98,10 @@ WorkspacePanelDropIndicator::WorkspacePanelDropIndicator(QWidget* parent)
         mCentral(NULL),
         mPrelightItem(NULL),
         mAnimating(false),
-        mFadeAnimation(NULL)
+        mFadeAnimation(NULL),
+        mSnapshotBytes(0),
+        mSnapshotBudget(kSnapshotBudget),
+        mRepaintingUncovered(false)
 {
     setObjectName("WorkspacePanelDropIndicator");
 
@@ -122,8 +148,8 @@ WorkspacePanelDropIndicator::WorkspacePanelDropIndicator(QWidget* parent)
 
     // Set up the opacity animation
     mFadeAnimation = new QPropertyAnimation(this);
-    mFadeAnimation->setTargetObject(mFader);
-    mFadeAnimation->setPropertyName("opacity");
+    mFadeAnimation->setTargetObject(this);
+    mFadeAnimation->setPropertyName("fadeOpacity");
     mFadeAnimation->setEasingCurve(QEasingCurve::InOutQuad);
 
     // Watch for completion of animation
@@ -145,6 +171,7 @@ WorkspacePanelDropIndicator::setPanel(QWidget* inPanel)
     if (mPanel == inPanel)
         return;
 
+    const QRect oldGeometry = isVisible() ? geometry() : QRect();
     mPanel = inPanel;
 
     if (mPanel != NULL) {
@@ -153,18 +180,30 @@ WorkspacePanelDropIndicator::setPanel(QWidget* inPanel)
             mPrelightItem->stopPrelight();
             mPrelightItem = NULL;
         }
+        mPrelightArea = AreaNone;
         mFadeAnimation->stop();
-        mFader->setOpacity(kStartFadeValue);
+        setFadeOpacity(kStartFadeValue);
+
+        if (mMode == ModeOverlay) {
+            // Nothing to grab, just cover the panel and paint over it
+            updateGeometry();
+            raise();
+            show();
+            viewport()->update();
+        } else {
+            // hide while we update, to prevent flicker
+            hide();
 
-        // hide while we update, to prevent flicker
-        hide();
+            // update geometries
+            updateGeometry();
+            updateOffscreen();
 
-        // update geometries
-        updateGeometry();
-        updateOffscreen();
+            // show ourselves again
+            show();
+        }
 
-        // show ourselves again
-        show();
+        // Repaint the panel left behind, while it is known to be unchanged
+        repaintUncovered(oldGeometry);
 
         // animate the fade in
         fadeIn();
@@ -182,9 +221,7 @@ WorkspacePanelDropIndicator::setDropPos(const QPoint& globalPos)
         return;
 
     mDropPos = globalPos;
-    Area area = calcDropArea();
-    if (area != mDropArea)
-        mDropArea = area;
+    mDropArea = mZones.classify(mapFromGlobal(mDropPos));
 
 #ifdef DEBUG_DROP_AREA
     switch (mDropArea) {
@@ -219,126 +256,71 @@ WorkspacePanelDropIndicator::setDropPos(const QPoint& globalPos)
     }
 #endif            
 
-    prelightDropArea(globalPos);
+    setPrelightArea(mDropArea);
 }
 
 
-WorkspacePanelDropIndicator::Area
-WorkspacePanelDropIndicator::calcDropArea() const
+void
+WorkspacePanelDropIndicator::prelightDropArea(const QPoint& inPosition)
 {
-    const QRect boundingRect(QPoint(0,0), size());
-    const QPoint panelPos = mapFromGlobal(mDropPos);
-
-    // First, figure out if the dropPos is over the central rectangle
-    // (for adding to a panel group).
-    //const int marginX = boundingRect.width() / 4;
-    //const int marginY = boundingRect.height() / 4;
-    //if (marginX > 0 && marginY > 0) {
-    const QRect centralRect = calculateCentralRect(boundingRect);
-    if (centralRect.contains(panelPos)){
-        return mCentralAreaEnabled ? AreaCentral : AreaNone;
-    }
-
-    // It's not over the central frame. Figure out which quadrant
-    // it's in. Calculate the slope of the two dividing lines, and
-    // see if position lies above or below each line.
-    //
-    // NW                    NE
-    //  +--------------------+
-    //  |\                  /|
-    //  | \                / |
-    //  |  \              /  |
-    //  |   \            /   |
-    //  | above     above NW |
-    //  | SW to NE  to / SE  |
-    //  |      \      /      |
-    //  |       \    /       |
-    //  |        \  /        |
-    //  |         \/         |
-    //  |         /\         |
-    //  |        /  \        |
-    //  |       /    \       |
-    //  |      /      \      |
-    //  |     /        \     |
-    //  |    /          \    |
-    //  |   /            \   |
-    //  |  /              \  |
-    //  | /                \ |
-    //  |/                  \|
-    //  +--------------------+
-    // SW                    SE
-
-    const float slopeToSE = boundingRect.height() / float(boundingRect.width());
-    const float slopeToNE = -slopeToSE;
-
-    const bool pointAboveNWtoSE = panelPos.y() <
-        (slopeToSE * panelPos.x() + 0         );
-
-    const bool pointAboveSWtoNE = panelPos.y() <
-        (slopeToNE * panelPos.x() + boundingRect.height());
-
-    Area area = mDropArea;
-    if (pointAboveSWtoNE){
-        if (pointAboveNWtoSE){
-            area = AreaNorth;
-        } else {
-            area = AreaWest;
-        }
-    } else {
-        if (pointAboveNWtoSE){
-            area = AreaEast;
-        } else {
-            area = AreaSouth;
-        }
-    }
-    return area;
+    setPrelightArea(mZones.classify(mapFromGlobal(inPosition)));
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::setPrelightArea
+//
+/// Prelight a drop zone. Nothing happens unless the zone changes, so the
+/// prelight animations only start on a transition.
+/// \param inArea The zone, AreaNone for no prelighting.
+//-----------------------------------------------------------------------------
 void
-WorkspacePanelDropIndicator::prelightDropArea(const QPoint& inPosition)
+WorkspacePanelDropIndicator::setPrelightArea(Area inArea)
 {
-    // Find the item to prelight
-    QGraphicsItem* item = itemAt(mapFromGlobal(inPosition));
-    if (item == NULL)
-        return;
-
-    // Make sure it is one of our zones
-    DynamicPolygonItem* polygonItem = dynamic_cast<DynamicPolygonItem*>(item);
-    if (polygonItem == NULL)
+    if (inArea == mPrelightArea)
         return;
 
-    // Check and see if there is anything to do
-    if (polygonItem == mPrelightItem)
-        return;
+    if (mMode == ModeOverlay) {
+        // Repaint the zones whose prelighting changes
+        QRectF dirty = mZones.getPolygon(mPrelightArea).boundingRect();
+        dirty |= mZones.getPolygon(inArea).boundingRect();
+        viewport()->update(dirty.toAlignedRect().adjusted(-1, -1, 1, 1));
+    } else {
+        // Turn off previous prelighting
+        if (mPrelightItem != NULL)
+            mPrelightItem->setPrelight(false);
 
-    // Check and see if we are over the central area and cannot accept a drop there.
-    bool canAcceptDrop = true;
-    if (polygonItem == mCentral && mCentralAreaEnabled == false) {
-        canAcceptDrop = false;
+        // Draw the new prelighting
+        mPrelightItem = getZoneItem(inArea);
+        if (mPrelightItem != NULL)
+            mPrelightItem->setPrelight(true);
     }
-    
-    // Stop the previous hover timer
-    mHoverTimer.stop();
-    
-    // Check and see if we have to clear out the last prelight
-    if (polygonItem != NULL) {
 
-        // Turn off previous prelighting
-        if (mPrelightItem != NULL) {
-            mPrelightItem->setPrelight(false);
-        }
+    mPrelightArea = inArea;
+}
 
-        if (canAcceptDrop) {
-            // Set the new prelight widget
-            mPrelightItem = polygonItem;
 
-            // Draw the new prelighting
-            mPrelightItem->setPrelight(true);
-        } else {
-            // There is no prelight area.
-            mPrelightItem = NULL;
-        }
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::getZoneItem
+//
+/// \result The scene item drawing a drop zone, NULL for AreaNone.
+//-----------------------------------------------------------------------------
+DynamicPolygonItem*
+WorkspacePanelDropIndicator::getZoneItem(Area inArea) const
+{
+    switch (inArea) {
+        case AreaNorth:
+            return mNorth;
+        case AreaSouth:
+            return mSouth;
+        case AreaEast:
+            return mEast;
+        case AreaWest:
+            return mWest;
+        case AreaCentral:
+            return mCentral;
+        default:
+            return NULL;
     }
 }
 
@@ -347,6 +329,9 @@ void
 WorkspacePanelDropIndicator::updateGeometry()
 {
     setGeometry(mPanel->frameGeometry());
+
+    // Compute the zones once for this panel
+    mZones.setBounds(QRect(QPoint(0,0), size()));
 }
 
 
@@ -359,20 +344,15 @@ WorkspacePanelDropIndicator::updateOffscreen()
     // Adjust our bounds to our parents
     resize(mPanel->width(), mPanel->height());
 
-    // Grab the offscreen of our parent
-#ifdef Q_OS_MACX    
-    QPixmap pixmap = mPanel->grab(QRect(0,
-                                        0,
-                                        mPanel->width(),
-                                        mPanel->height()));
-#else
-    QPixmap pixmap = QPixmap::grabWindow(mPanel->winId(),
-                                         0,
-                                         0,
-                                         mPanel->width(),
-                                         mPanel->height());
-#endif
+    // Sweeping back and forth over the same panels grabs each only once
+    QPixmap pixmap;
+    if (!findSnapshot(mPanel, pixmap))
+        pixmap = storeSnapshot(mPanel, grabPanel());
 
+    // A downscaled snapshot is stretched back over the panel
+    mBackground->setTransformationMode(Qt::SmoothTransformation);
+    const qreal pixmapWidth = pixmap.width() / pixmap.devicePixelRatio();
+    mBackground->setScale(pixmapWidth > 0 ? mPanel->width() / pixmapWidth : 1.0);
     mBackground->setPixmap(pixmap);
 
     // Update the bounds of the opacity fader
@@ -382,53 +362,11 @@ WorkspacePanelDropIndicator::updateOffscreen()
                     mPanel->height());
 
     // Udpate the drop zone polygons
-    QVector<QPointF> pts(4);
-
-    // Calculate the bounding rect
-    const QRect boundingRect(QPoint(0,0), mPanel->size());
-
-    // Calculate the central rect
-    const QRect centralRect = calculateCentralRect(boundingRect);
-
-    // North
-    pts[0] = boundingRect.topLeft();
-    pts[1] = boundingRect.topRight();
-    pts[2] = centralRect.topRight();
-    pts[3] = centralRect.topLeft();
-    QPolygonF northPolygon(pts);
-    mNorth->setPolygon(northPolygon);
-
-    // East
-    pts[0] = boundingRect.topRight();
-    pts[1] = boundingRect.bottomRight();
-    pts[2] = centralRect.bottomRight();
-    pts[3] = centralRect.topRight();
-    QPolygonF eastPolygon(pts);
-    mEast->setPolygon(eastPolygon);
-
-    // South
-    pts[0] = boundingRect.bottomRight();
-    pts[1] = boundingRect.bottomLeft();
-    pts[2] = centralRect.bottomLeft();
-    pts[3] = centralRect.bottomRight();
-    QPolygonF southPolygon(pts);
-    mSouth->setPolygon(southPolygon);
-
-    // West
-    pts[0] = boundingRect.bottomLeft();
-    pts[1] = boundingRect.topLeft();
-    pts[2] = centralRect.topLeft();
-    pts[3] = centralRect.bottomLeft();
-    QPolygonF westPolygon(pts);
-    mWest->setPolygon(westPolygon);
-
-    // Central
-    pts[0] = centralRect.topLeft();
-    pts[1] = centralRect.topRight();
-    pts[2] = centralRect.bottomRight();
-    pts[3] = centralRect.bottomLeft();
-    QPolygonF centralPolygon(pts);
-    mCentral->setPolygon(centralPolygon);
+    mNorth->setPolygon(mZones.getPolygon(AreaNorth));
+    mEast->setPolygon(mZones.getPolygon(AreaEast));
+    mSouth->setPolygon(mZones.getPolygon(AreaSouth));
+    mWest->setPolygon(mZones.getPolygon(AreaWest));
+    mCentral->setPolygon(mZones.getPolygon(AreaCentral));
 
     // Make sure we are top most and visible
     raise();
@@ -436,6 +374,244 @@ WorkspacePanelDropIndicator::updateOffscreen()
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::grabPanel
+//
+/// Grab the current contents of the panel from the screen.
+//-----------------------------------------------------------------------------
+QPixmap
+WorkspacePanelDropIndicator::grabPanel() const
+{
+#ifdef Q_OS_MACX    
+    return mPanel->grab(QRect(0,
+                              0,
+                              mPanel->width(),
+                              mPanel->height()));
+#else
+    return QPixmap::grabWindow(mPanel->winId(),
+                               0,
+                               0,
+                               mPanel->width(),
+                               mPanel->height());
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::findSnapshot
+//
+/// Look for a background grabbed earlier in the drag. A snapshot is only
+/// used while the panel has the same size and, for a panel group, the
+/// same tabs and current tab.
+/// \param inPanel The panel.
+/// \param outPixmap Set to the snapshot.
+/// \result True if there is a usable snapshot.
+//-----------------------------------------------------------------------------
+bool
+WorkspacePanelDropIndicator::findSnapshot(QWidget* inPanel, QPixmap& outPixmap) const
+{
+    QHash<QWidget*, Snapshot>::const_iterator iter = mSnapshots.find(inPanel);
+    if (iter == mSnapshots.end())
+        return false;
+
+    const Snapshot& snapshot = iter.value();
+    const QTabWidget* tabWidget = qobject_cast<QTabWidget*>(inPanel);
+    if (snapshot.size != inPanel->size()
+        || (tabWidget != NULL && (snapshot.currentIndex != tabWidget->currentIndex()
+                                  || snapshot.count != tabWidget->count())))
+        return false;
+
+    outPixmap = snapshot.pixmap;
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::storeSnapshot
+//
+/// Cache a grabbed background. The oldest snapshots are dropped to make
+/// room for it. Only a grab that would not fit in the budget even on its
+/// own is stored at half size.
+/// \param inPanel The panel that was grabbed.
+/// \param inPixmap The grab.
+/// \result The pixmap to display, which may be the downscaled one.
+//-----------------------------------------------------------------------------
+QPixmap
+WorkspacePanelDropIndicator::storeSnapshot(QWidget* inPanel, const QPixmap& inPixmap)
+{
+    removeSnapshot(inPanel);
+
+    Snapshot snapshot;
+    snapshot.pixmap = inPixmap;
+    snapshot.size = inPanel->size();
+    snapshot.currentIndex = -1;
+    snapshot.count = 0;
+
+    const QTabWidget* tabWidget = qobject_cast<QTabWidget*>(inPanel);
+    if (tabWidget != NULL) {
+        snapshot.currentIndex = tabWidget->currentIndex();
+        snapshot.count = tabWidget->count();
+    }
+
+    // Dropping every other snapshot would still not make room
+    qint64 bytes = getPixmapBytes(inPixmap);
+    if (bytes > mSnapshotBudget) {
+        snapshot.pixmap = inPixmap.scaled(inPixmap.size() / 2, 
+                                          Qt::IgnoreAspectRatio, 
+                                          Qt::SmoothTransformation);
+        bytes = getPixmapBytes(snapshot.pixmap);
+
+        // Not even at half size, so the panel is not kept
+        if (bytes > mSnapshotBudget)
+            return inPixmap;
+    }
+
+    while (mSnapshotBytes + bytes > mSnapshotBudget && !mSnapshotOrder.isEmpty())
+        removeSnapshot(mSnapshotOrder.first());
+
+    // Any repaint of the panel, or of a widget in it, means new contents
+    QList<QWidget*> widgets = inPanel->findChildren<QWidget*>();
+    widgets.prepend(inPanel);
+    Q_FOREACH(QWidget* widget, widgets) {
+        widget->installEventFilter(this);
+        snapshot.watched.append(widget);
+    }
+
+    mSnapshots.insert(inPanel, snapshot);
+    mSnapshotOrder.append(inPanel);
+    mSnapshotBytes += bytes;
+    connect(inPanel, SIGNAL(destroyed(QObject*)), this, SLOT(onSnapshotPanelDestroyed(QObject*)));
+
+    return snapshot.pixmap;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::removeSnapshot
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::removeSnapshot(QWidget* inPanel)
+{
+    QHash<QWidget*, Snapshot>::iterator iter = mSnapshots.find(inPanel);
+    if (iter == mSnapshots.end())
+        return;
+
+    mSnapshotBytes -= getPixmapBytes(iter.value().pixmap);
+
+    Q_FOREACH(const QPointer<QWidget>& widget, iter.value().watched) {
+        if (!widget.isNull())
+            widget->removeEventFilter(this);
+    }
+
+    disconnect(inPanel, SIGNAL(destroyed(QObject*)), this, SLOT(onSnapshotPanelDestroyed(QObject*)));
+    mSnapshots.erase(iter);
+    mSnapshotOrder.removeAll(inPanel);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::repaintUncovered
+//
+/// Repaint what the indicator covered at once. The panels there repaint
+/// because they were uncovered, not because they changed, so their
+/// snapshots are kept.
+/// \param inOldGeometry The area the indicator covered.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::repaintUncovered(const QRect& inOldGeometry)
+{
+    QWidget* parent = parentWidget();
+    if (parent == NULL || inOldGeometry.isEmpty() || mSnapshots.isEmpty())
+        return;
+
+    QRegion uncovered(inOldGeometry);
+    if (isVisible())
+        uncovered -= geometry();
+
+    mRepaintingUncovered = true;
+    parent->repaint(uncovered);
+    mRepaintingUncovered = false;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::clearSnapshotCache
+//
+/// Drop all grabbed backgrounds. Called when a drag ends.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::clearSnapshotCache()
+{
+    while (!mSnapshotOrder.isEmpty())
+        removeSnapshot(mSnapshotOrder.first());
+
+    Q_ASSERT(mSnapshotBytes == 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::invalidateSnapshot
+//
+/// Drop the background grabbed for a panel whose contents changed, so
+/// that it is grabbed again. Repaints of the panel do this by themselves.
+/// \param inPanel The panel.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::invalidateSnapshot(QWidget* inPanel)
+{
+    removeSnapshot(inPanel);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::setSnapshotBudget
+//
+/// Set how much memory grabbed backgrounds may use.
+/// \param inBytes The budget in bytes.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::setSnapshotBudget(qint64 inBytes)
+{
+    mSnapshotBudget = qMax(qint64(0), inBytes);
+
+    while (mSnapshotBytes > mSnapshotBudget && !mSnapshotOrder.isEmpty())
+        removeSnapshot(mSnapshotOrder.first());
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::eventFilter
+//
+/// Drop the snapshot of a panel group when anything in it repaints, other
+/// than for being uncovered by the indicator.
+//-----------------------------------------------------------------------------
+bool
+WorkspacePanelDropIndicator::eventFilter(QObject* inObject, QEvent* inEvent)
+{
+    if (inEvent->type() == QEvent::Paint && !mRepaintingUncovered) {
+        QWidget* widget = qobject_cast<QWidget*>(inObject);
+        while (widget != NULL && !mSnapshots.contains(widget))
+            widget = widget->parentWidget();
+
+        if (widget != NULL)
+            removeSnapshot(widget);
+    }
+
+    return QGraphicsView::eventFilter(inObject, inEvent);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::onSnapshotPanelDestroyed    [slot]
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::onSnapshotPanelDestroyed(QObject* inPanel)
+{
+    // Only the pointer is used, the widget is already gone
+    removeSnapshot(static_cast<QWidget*>(inPanel));
+}
+
+
 //-----------------------------------------------------------------------------
 // WorkspacePanelDropIndicator::fadeIn
 //-----------------------------------------------------------------------------
@@ -445,7 +621,8 @@ WorkspacePanelDropIndicator::fadeIn()
     mAnimating = true;
 
     // Set up the fade in amount
-    mFadeAnimation->setDuration(kFadeInSpeed);
+    mFadeFrameTimer.invalidate();
+    mFadeAnimation->setDuration(AnimationMonitor::instance()->getDuration(kFadeInSpeed, mAnimationPolicy));
     mFadeAnimation->setStartValue(kStartFadeValue);
     mFadeAnimation->setEndValue(kEndFadeValue);
 
@@ -466,7 +643,8 @@ WorkspacePanelDropIndicator::fadeOut()
         return;
 
     // Set up the fade out amount
-    mFadeAnimation->setDuration(kFadeOutSpeed); 
+    mFadeFrameTimer.invalidate();
+    mFadeAnimation->setDuration(AnimationMonitor::instance()->getDuration(kFadeOutSpeed, mAnimationPolicy));
     mFadeAnimation->setStartValue(kEndFadeValue);
     mFadeAnimation->setEndValue(kEndFadeValue + kFadeOutValue); 
 
@@ -476,28 +654,114 @@ WorkspacePanelDropIndicator::fadeOut()
 
 
 //-----------------------------------------------------------------------------
-// WorkspacePanelDropIndicator::calculateCentralRect
+// WorkspacePanelDropIndicator::setMode
 //
-/// Given a bounding rectangle, calculate the central rectangle, 
-/// adjusting the margins so the central rectangle appears uniform 
-/// when centered in the bounding rectangle. 
-/// \param inRect The bounding rectangle.
-/// \result The central rectangle.
+/// Choose how the indicator is drawn. The overlay mode paints the fader
+/// and the drop zones in a single paint event over the live panel, with
+/// no screen grab and no scene. Its prelighting does not animate.
+/// \param inMode The mode.
 //-----------------------------------------------------------------------------
-QRect 
-WorkspacePanelDropIndicator::calculateCentralRect(const QRect& inRect) const
+void
+WorkspacePanelDropIndicator::setMode(Mode inMode)
 {
-   int marginX = std::max(1, inRect.width() / 4);
-    int marginY = std::max(1, inRect.height() / 4);
+    if (inMode == mMode)
+        return;
 
-    // We want the margins to appear uniform.
-    if (marginX > marginY)
-        marginX = marginY;
+    mMode = inMode;
+
+    // The overlay shows the panel underneath through the viewport
+    viewport()->setAutoFillBackground(mMode == ModeScene);
+    mFader->setOpacity(mFadeOpacity);
+    mPrelightArea = AreaNone;
 
-    if (marginY > marginX)
-        marginY = marginX;
+    if (mPrelightItem != NULL) {
+        mPrelightItem->stopPrelight();
+        mPrelightItem = NULL;
+    }
+
+    if (mPanel != NULL && mMode == ModeScene)
+        updateOffscreen();
 
-    return inRect.adjusted(marginX, marginY, -marginX, -marginY);
+    viewport()->update();
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::setFadeOpacity
+//
+/// Set the opacity of the darkening fader. Driven by the fade animation,
+/// whose frame times are reported to the AnimationMonitor.
+/// \param inOpacity The opacity.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::setFadeOpacity(qreal inOpacity)
+{
+    if (mFadeAnimation->state() == QAbstractAnimation::Running) {
+        if (mFadeFrameTimer.isValid())
+            AnimationMonitor::instance()->reportFrame(mFadeFrameTimer.restart());
+        else
+            mFadeFrameTimer.start();
+    }
+
+    mFadeOpacity = inOpacity;
+
+    if (mMode == ModeScene)
+        mFader->setOpacity(inOpacity);
+    else
+        viewport()->update();
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::setAnimationPolicy
+//
+/// Set how the fades and the prelighting of the drop zones are shortened
+/// or skipped when the workspace cannot animate smoothly.
+/// \param inPolicy The policy.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::setAnimationPolicy(const AnimationMonitor::Policy& inPolicy)
+{
+    mAnimationPolicy = inPolicy;
+
+    mNorth->setAnimationPolicy(inPolicy);
+    mEast->setAnimationPolicy(inPolicy);
+    mSouth->setAnimationPolicy(inPolicy);
+    mWest->setAnimationPolicy(inPolicy);
+    mCentral->setAnimationPolicy(inPolicy);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::paintEvent
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::paintEvent(QPaintEvent* inEvent)
+{
+    if (mMode != ModeOverlay) {
+        QGraphicsView::paintEvent(inEvent);
+        return;
+    }
+
+    QPainter painter(viewport());
+    painter.setClipRegion(inEvent->region());
+
+    // Darken the panel
+    const QRect& boundingRect = mZones.getBounds();
+    QColor faderColor(Qt::black);
+    faderColor.setAlphaF(mFadeOpacity);
+    painter.fillRect(boundingRect, faderColor);
+
+    // Draw the drop zones
+    static const Area kZones[] = { AreaNorth, AreaEast, AreaSouth, AreaWest, AreaCentral };
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(kZoneOutlineColor);
+    for (size_t index = 0; index < sizeof(kZones) / sizeof(kZones[0]); ++index) {
+        const Area zone = kZones[index];
+        painter.setBrush(zone == mPrelightArea ? kZonePrelightColor : kZoneColor);
+        painter.drawPolygon(mZones.getPolygon(zone));
+    }
 }
 
 
@@ -507,6 +771,157 @@ WorkspacePanelDropIndicator::calculateCentralRect(const QRect& inRect) const
 void
 WorkspacePanelDropIndicator::animationFinished()
 {
-    if (!mAnimating) 
+    if (!mAnimating) {
         hide();
+        repaintUncovered(geometry());
+    }
+}
+
+
+//=============================================================================
+// class WorkspacePanelDropIndicator::ZoneModel
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::ZoneModel::ZoneModel
+//-----------------------------------------------------------------------------
+WorkspacePanelDropIndicator::ZoneModel::ZoneModel()
+    :   mCentralAreaEnabled(true)
+{
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::ZoneModel::ZoneModel
+//
+/// \param inBounds The bounding rectangle of the target panel.
+//-----------------------------------------------------------------------------
+WorkspacePanelDropIndicator::ZoneModel::ZoneModel(const QRect& inBounds)
+    :   mCentralAreaEnabled(true)
+{
+    setBounds(inBounds);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::ZoneModel::setBounds
+//
+/// Compute the zones for a target. The central rectangle is inset by
+/// uniform margins of a quarter of the smaller side, and the four edge
+/// zones are the trapezoids between it and the bounding rectangle.
+/// \param inBounds The bounding rectangle of the target panel.
+//-----------------------------------------------------------------------------
+void
+WorkspacePanelDropIndicator::ZoneModel::setBounds(const QRect& inBounds)
+{
+    mBounds = inBounds;
+
+    // We want the margins to appear uniform.
+    const int margin = qMin(qMax(1, inBounds.width() / 4), qMax(1, inBounds.height() / 4));
+    mCentralRect = inBounds.adjusted(margin, margin, -margin, -margin);
+
+    const QRect& outer = mBounds;
+    const QRect& inner = mCentralRect;
+
+    mPolygons[AreaNone] = QPolygonF();
+
+    mPolygons[AreaNorth] = QPolygonF() 
+        << outer.topLeft() << outer.topRight() << inner.topRight() << inner.topLeft();
+
+    mPolygons[AreaEast] = QPolygonF() 
+        << outer.topRight() << outer.bottomRight() << inner.bottomRight() << inner.topRight();
+
+    mPolygons[AreaSouth] = QPolygonF() 
+        << outer.bottomRight() << outer.bottomLeft() << inner.bottomLeft() << inner.bottomRight();
+
+    mPolygons[AreaWest] = QPolygonF() 
+        << outer.bottomLeft() << outer.topLeft() << inner.topLeft() << inner.bottomLeft();
+
+    mPolygons[AreaCentral] = QPolygonF() 
+        << inner.topLeft() << inner.topRight() << inner.bottomRight() << inner.bottomLeft();
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::ZoneModel::classify
+//
+/// Find the drop zone under a position.
+/// \param inPosition The position, in the coordinates of the bounds.
+/// \result The zone. AreaNone if there are no bounds, or if the position
+/// is over the central rectangle and the central area is disabled.
+//-----------------------------------------------------------------------------
+WorkspacePanelDropIndicator::Area
+WorkspacePanelDropIndicator::ZoneModel::classify(const QPoint& inPosition) const
+{
+    if (mBounds.isEmpty())
+        return AreaNone;
+
+    // First, figure out if the position is over the central rectangle
+    // (for adding to a panel group).
+    if (mCentralRect.contains(inPosition))
+        return mCentralAreaEnabled ? AreaCentral : AreaNone;
+
+    // It's not over the central frame. Figure out which quadrant
+    // it's in. See if the position lies above or below each of the
+    // two diagonals. Comparing cross products keeps this in integers.
+    //
+    // NW                    NE
+    //  +--------------------+
+    //  |\                  /|
+    //  | \                / |
+    //  |  \              /  |
+    //  |   \            /   |
+    //  | above     above NW |
+    //  | SW to NE  to / SE  |
+    //  |      \      /      |
+    //  |       \    /       |
+    //  |        \  /        |
+    //  |         \/         |
+    //  |         /\         |
+    //  |        /  \        |
+    //  |       /    \       |
+    //  |      /      \      |
+    //  |     /        \     |
+    //  |    /          \    |
+    //  |   /            \   |
+    //  |  /              \  |
+    //  | /                \ |
+    //  |/                  \|
+    //  +--------------------+
+    // SW                    SE
+
+    const qint64 x = inPosition.x() - mBounds.left();
+    const qint64 y = inPosition.y() - mBounds.top();
+    const qint64 width = mBounds.width();
+    const qint64 height = mBounds.height();
+
+    const bool pointAboveNWtoSE = y * width < height * x;
+    const bool pointAboveSWtoNE = y * width < height * (width - x);
+
+    if (pointAboveSWtoNE)
+        return pointAboveNWtoSE ? AreaNorth : AreaWest;
+
+    return pointAboveNWtoSE ? AreaEast : AreaSouth;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspacePanelDropIndicator::ZoneModel::getAnchor
+//
+/// Get a point well inside a zone, e.g. to drop on it from the keyboard.
+/// \param inArea The zone.
+/// \result The centroid of the zone outline.
+//-----------------------------------------------------------------------------
+QPoint
+WorkspacePanelDropIndicator::ZoneModel::getAnchor(Area inArea) const
+{
+    const QPolygonF& polygon = mPolygons[inArea];
+    if (polygon.isEmpty())
+        return mBounds.center();
+
+    QPointF sum;
+    Q_FOREACH(const QPointF& point, polygon)
+        sum += point;
+
+    return (sum / polygon.count()).toPoint();
 }
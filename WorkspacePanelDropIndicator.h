@@ -22,10 +22,18 @@ THE SOFTWARE.
 #define WORKSPACE_PANEL_DROP_INDICATOR_HAS_BEEN_INCLUDED
 
 // Qt
+#include <QElapsedTimer>
 #include <QGraphicsScene>
 #include <QGraphicsView>
+#include <QHash>
+#include <QPixmap>
+#include <QPointer>
+#include <QPolygonF>
 #include <QTimer>
 
+// Local
+#include "AnimationMonitor.h"
+
 // Forward declarations
 class DynamicPolygonItem;
 class DynamicRectItem;
@@ -42,6 +50,7 @@ class QPropertyAnimation;
 class WorkspacePanelDropIndicator : public QGraphicsView
 {
     Q_OBJECT
+    Q_PROPERTY(qreal fadeOpacity READ fadeOpacity WRITE setFadeOpacity)
 
 public:
     enum Area {
@@ -53,6 +62,42 @@ public:
         AreaCentral
     };
 
+    /// How the indicator is drawn
+    enum Mode {
+        ModeScene,      ///< Zones in a graphics scene over a grab of the panel
+        ModeOverlay     ///< Zones painted straight over the live panel
+    };
+
+    /// \brief The drop zones of one target panel.
+    ///
+    /// The geometry is computed once when the bounds are set, after which
+    /// a position is classified with a few integer comparisons. It needs
+    /// no indicator, so keyboard docking and tests can use it directly.
+    ///
+    class ZoneModel
+    {
+    public:
+        ZoneModel();
+        explicit ZoneModel(const QRect& inBounds);
+
+        void setBounds(const QRect& inBounds);
+        const QRect& getBounds() const;
+        const QRect& getCentralRect() const;
+
+        void setCentralAreaEnabled(bool inEnabled);
+        bool isCentralAreaEnabled() const;
+
+        Area classify(const QPoint& inPosition) const;
+        const QPolygonF& getPolygon(Area inArea) const;
+        QPoint getAnchor(Area inArea) const;
+
+    private:
+        QRect mBounds;
+        QRect mCentralRect;
+        bool mCentralAreaEnabled;
+        QPolygonF mPolygons[AreaCentral + 1];
+    };
+
     WorkspacePanelDropIndicator(QWidget* parent = 0);
     ~WorkspacePanelDropIndicator();
 
@@ -69,32 +114,64 @@ public:
     // Get the Area corresponding to the drop position
     Area getDropArea() const;
 
+    // Get the drop zones of the current panel
+    const ZoneModel& getZoneModel() const;
+
     // TODO: We want to get rid of this.
     // Prelighting should be done by the standard event handling
     // mechanism if possible.
     void prelightDropArea(const QPoint& inPosition);
 
+    void setMode(Mode inMode);
+    Mode getMode() const;
+
+    qreal fadeOpacity() const;
+    void setFadeOpacity(qreal inOpacity);
+
+    // How the fades and prelighting degrade under load
+    void setAnimationPolicy(const AnimationMonitor::Policy& inPolicy);
+    const AnimationMonitor::Policy& getAnimationPolicy() const;
+
+    // Panel backgrounds grabbed during the current drag
+    void clearSnapshotCache();
+    void invalidateSnapshot(QWidget* inPanel);
+    void setSnapshotBudget(qint64 inBytes);
+    qint64 getSnapshotBudget() const;
+
+protected:
+    virtual bool eventFilter(QObject* inObject, QEvent* inEvent);
+    virtual void paintEvent(QPaintEvent* inEvent);
+
 private Q_SLOTS:
     void animationFinished();
+    void onSnapshotPanelDestroyed(QObject* inPanel);
 
 private:
     // No copying
     Q_DISABLE_COPY(WorkspacePanelDropIndicator)
 
     void updateGeometry();
-    Area calcDropArea() const;
+    void setPrelightArea(Area inArea);
+    DynamicPolygonItem* getZoneItem(Area inArea) const;
 
     void updateOffscreen();
 
     void fadeIn();
     void fadeOut();
 
-    QRect calculateCentralRect(const QRect& inRect) const;
+    QPixmap grabPanel() const;
+    bool findSnapshot(QWidget* inPanel, QPixmap& outPixmap) const;
+    QPixmap storeSnapshot(QWidget* inPanel, const QPixmap& inPixmap);
+    void removeSnapshot(QWidget* inPanel);
+    void repaintUncovered(const QRect& inOldGeometry);
     
     QWidget* mPanel;
     QPoint mDropPos;
     Area mDropArea;
-    bool mCentralAreaEnabled;
+    ZoneModel mZones;
+    Mode mMode;
+    qreal mFadeOpacity;
+    Area mPrelightArea;
 
     QGraphicsScene mScene;
     QGraphicsPixmapItem* mBackground;
@@ -107,13 +184,40 @@ private:
     DynamicPolygonItem* mPrelightItem;
     bool mAnimating;
     QPropertyAnimation* mFadeAnimation;
-    QBasicTimer mHoverTimer;
+    AnimationMonitor::Policy mAnimationPolicy;
+    QElapsedTimer mFadeFrameTimer;
+
+    // A grabbed background, and the panel state it was grabbed in
+    struct Snapshot {
+        QPixmap pixmap;
+        QSize size;
+        int currentIndex;
+        int count;
+        QList<QPointer<QWidget> > watched;
+    };
+
+    QHash<QWidget*, Snapshot> mSnapshots;
+    QList<QWidget*> mSnapshotOrder;
+    qint64 mSnapshotBytes;
+    qint64 mSnapshotBudget;
+    bool mRepaintingUncovered;
 };
 
 inline const QPoint& WorkspacePanelDropIndicator::getDropPos() const { return mDropPos; }
 inline WorkspacePanelDropIndicator::Area WorkspacePanelDropIndicator::getDropArea() const { return mDropArea; }
-inline void WorkspacePanelDropIndicator::enableCentralArea() { mCentralAreaEnabled = true; }
-inline void WorkspacePanelDropIndicator::disableCentralArea() { mCentralAreaEnabled = false; }
+inline const WorkspacePanelDropIndicator::ZoneModel& WorkspacePanelDropIndicator::getZoneModel() const { return mZones; }
+inline void WorkspacePanelDropIndicator::enableCentralArea() { mZones.setCentralAreaEnabled(true); }
+inline void WorkspacePanelDropIndicator::disableCentralArea() { mZones.setCentralAreaEnabled(false); }
+inline WorkspacePanelDropIndicator::Mode WorkspacePanelDropIndicator::getMode() const { return mMode; }
+inline qreal WorkspacePanelDropIndicator::fadeOpacity() const { return mFadeOpacity; }
+inline const AnimationMonitor::Policy& WorkspacePanelDropIndicator::getAnimationPolicy() const { return mAnimationPolicy; }
+inline qint64 WorkspacePanelDropIndicator::getSnapshotBudget() const { return mSnapshotBudget; }
+
+inline const QRect& WorkspacePanelDropIndicator::ZoneModel::getBounds() const { return mBounds; }
+inline const QRect& WorkspacePanelDropIndicator::ZoneModel::getCentralRect() const { return mCentralRect; }
+inline void WorkspacePanelDropIndicator::ZoneModel::setCentralAreaEnabled(bool inEnabled) { mCentralAreaEnabled = inEnabled; }
+inline bool WorkspacePanelDropIndicator::ZoneModel::isCentralAreaEnabled() const { return mCentralAreaEnabled; }
+inline const QPolygonF& WorkspacePanelDropIndicator::ZoneModel::getPolygon(Area inArea) const { return mPolygons[inArea]; }
 
 #endif // !WORKSPACE_PANEL_DROP_INDICATOR_HAS_BEEN_INCLUDED
 
@@ -396,13 +396,12 @@ WorkspacePanelGroup::onUndockCurrentPanel()
     WorkspacePanel* panel = qobject_cast<WorkspacePanel*>(widget);
     Q_ASSERT(panel != NULL);
 
-    // Undock the panel. We have to call setFloating twice so make 
-    // sure we reparent and set the window topmost.  Otherwise,
-    // QTabWidget will try to delete the widget.
-    panel->setFloating(true);       
+    // Undock the panel. Take it out of the group first, then float it
+    // in one step so that it gets a single floating frame. Removing the
+    // tab hid the panel.
     removeTab(currentIndex());
-    widget->setParent(parentWidget());
-    panel->setFloating(true);   
+    panel->setFloating(true);
+    panel->show();
 
     // We might have to update the layout if we floated the last 
     // panel in the tab group.
@@ -484,6 +483,9 @@ WorkspacePanelGroup::setActive(bool inActive)
         return;
 
     mActive = inActive;        
+
+    // Only the outline of the current tab changes
+    mTabBar->updateActiveOutline();
 }
 
 
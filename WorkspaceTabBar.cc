@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include <QtCore>
 #include <QtGui>
 #include <QApplication>
+#include <QPainter>
 #include <QStyle>
 #include <QStylePainter>
 #include <QTabBar>
@@ -34,6 +35,8 @@ THE SOFTWARE.
 //#include <widgets/SyncButton.h>
 
 // Local
+#include "ProgressClock.h"
+#include "TaskScheduler.h"
 #include "WorkspaceArea.h"
 #include "WorkspacePanel.h"
 #include "WorkspacePanelGroup.h"
@@ -42,6 +45,9 @@ THE SOFTWARE.
 // class WorkspaceTabBar
 //=============================================================================
 static const int kFontSize = 11;
+static const int kProgressSize = 12;
+static const int kProgressSpacing = 2;
+static const char* kProgressIndicatorName = "ProgressIndicator";
 
 
 //-----------------------------------------------------------------------------
@@ -53,6 +59,7 @@ WorkspaceTabBar::WorkspaceTabBar(WorkspacePanelGroup* inParent)
     ,   mHoverIndex(-1)
     ,   mDragging(false)
     ,   mActive(false)
+    ,   mSettleTaskId(-1)
 {
     // Set the standard behavior
     setDrawBase(true);
@@ -90,6 +97,7 @@ WorkspaceTabBar::WorkspaceTabBar(WorkspacePanelGroup* inParent)
 //-----------------------------------------------------------------------------
 WorkspaceTabBar::~WorkspaceTabBar() 
 {
+    TaskScheduler::instance()->cancel(mSettleTaskId);
 }
 
 
@@ -119,6 +127,11 @@ WorkspaceTabBar::tabInserted(int inIndex)
     QWidget* button = tabButton(inIndex, closeSide);
     if (button != NULL)
         button->setVisible(false);
+
+    // A panel that is still busy brings its progress indicator along
+    WorkspacePanel* thePanel = qobject_cast<WorkspacePanel*>(mParent->widget(inIndex));
+    if (thePanel != NULL && thePanel->isProgressActive())
+        startProgress(inIndex);
 }
 
 
@@ -129,6 +142,8 @@ void
 WorkspaceTabBar::tabRemoved(int inIndex)
 {
 	Q_UNUSED(inIndex);
+
+    pruneProgress();
 }
 
 
@@ -199,7 +214,8 @@ WorkspaceTabBar::mouseReleaseEvent(QMouseEvent* inEvent)
 
     // Give the possible tab drag animation time to finish
     // before allowing the active tab to draw.
-   	startTimer(200);
+    TaskScheduler::instance()->cancel(mSettleTaskId);
+    mSettleTaskId = TaskScheduler::instance()->schedule(this, SLOT(onDragSettled()), 200);
 }
 
 
@@ -252,6 +268,17 @@ WorkspaceTabBar::paintEvent(QPaintEvent* inEvent)
 {
     // Paint the default control.
     QTabBar::paintEvent(inEvent);
+
+    // Paint the busy indicators that need it
+    if (!mProgressPanels.isEmpty()) {
+        QPainter thePainter(this);
+        const int thePhase = ProgressClock::instance()->phase();
+        Q_FOREACH(QWidget* thePanel, mProgressPanels) {
+            const QRect theRect = getProgressRect(mParent->indexOf(thePanel));
+            if (theRect.intersects(inEvent->rect()))
+                drawProgress(thePainter, theRect, thePhase);
+        }
+    }
         
     // Check and see if we need to do active panel painting.
     if (!mParent->isActive())
@@ -313,16 +340,17 @@ WorkspaceTabBar::paintEvent(QPaintEvent* inEvent)
 
 
 //-----------------------------------------------------------------------------
-// WorkspaceTabBar::timerEvent()
+// WorkspaceTabBar::onDragSettled() [slot]
 //-----------------------------------------------------------------------------
 void 
-WorkspaceTabBar::timerEvent(QTimerEvent* inEvent)
+WorkspaceTabBar::onDragSettled()
 {
+    mSettleTaskId = -1;
+
     // We hope that the tab drag is complete
     if (mDragging) {
-        killTimer(inEvent->timerId());
         mDragging = false;
-        update();
+        updateActiveOutline();
     }
 }
 
@@ -391,30 +419,80 @@ WorkspaceTabBar::setActive(bool inActive)
         return;
 
     mActive = inActive; 
-    update();
+    updateActiveOutline();
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::updateActiveOutline()
+//
+/// Repaint the pixels of the active indication only, when the active
+/// state of the group changes. The rest of the tab bar is unchanged, and
+/// is not sent to the display again.
+//-----------------------------------------------------------------------------
+void
+WorkspaceTabBar::updateActiveOutline()
+{
+    update(getActiveOutlineRegion());
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::getActiveOutlineRegion()
+//
+/// \result The pixels that paintEvent may draw the active indication on:
+/// the bottom line of the bar and the outline of the current tab.
+//-----------------------------------------------------------------------------
+QRegion
+WorkspaceTabBar::getActiveOutlineRegion() const
+{
+    const QRect frame = rect();
+    QRegion theRegion(frame.left(), frame.bottom(), frame.width(), 1);
+
+    const QRect tabFrame = tabRect(currentIndex());
+    if (tabFrame.isValid()) {
+        theRegion += QRect(tabFrame.left(), tabFrame.top(), tabFrame.width(), 2);
+        theRegion += QRect(tabFrame.left(), tabFrame.top(), 2, tabFrame.height());
+        theRegion += QRect(tabFrame.right() - 1, tabFrame.top(), 2, tabFrame.height());
+    }
+
+    return theRegion;
 }
 
 
 //-----------------------------------------------------------------------------
 // WorkspaceTabBar::startProgress()
 //
-/// Activate the progress indicator
+/// Activate the progress indicator. Room for the indicator is reserved
+/// in a free tab button slot, preferably opposite the close button. All
+/// indicators are animated by the shared ProgressClock.
 /// \param inIndex The tab to indicate progress on.
 //-----------------------------------------------------------------------------
 void
 WorkspaceTabBar::startProgress(int inIndex)
 {
-//	QWidget* theButton = tabButton(inIndex, QTabBar::LeftSide);
-//	if (theButton == NULL)
-//		return;
-//
-//	workspace::SyncButton* syncButton =
-//		qobject_cast<workspace::SyncButton*>(theButton);
-//	if (syncButton == NULL)
-//		return;
-//		
-//	syncButton->show();
-//	syncButton->start();				
+    QWidget* thePanel = mParent->widget(inIndex);
+    if (thePanel == NULL || mProgressPanels.contains(thePanel))
+        return;
+
+    ButtonPosition theSide = getProgressSide();
+    if (tabButton(inIndex, theSide) != NULL)
+        theSide = theSide == QTabBar::LeftSide ? QTabBar::RightSide : QTabBar::LeftSide;
+
+    // With both slots taken getProgressRect() places it beside a button
+    if (tabButton(inIndex, theSide) == NULL) {
+        QWidget* theSpacer = new QWidget(this);
+        theSpacer->setObjectName(kProgressIndicatorName);
+        theSpacer->setFixedSize(kProgressSize, kProgressSize);
+        theSpacer->setAttribute(Qt::WA_TransparentForMouseEvents);
+        setTabButton(inIndex, theSide, theSpacer);
+    }
+
+    if (mProgressPanels.isEmpty())
+        ProgressClock::instance()->attach(this, SLOT(onProgressTick(int)));
+
+    mProgressPanels.insert(thePanel);
+    update(getProgressRect(inIndex));
 }
 
 
@@ -427,17 +505,163 @@ WorkspaceTabBar::startProgress(int inIndex)
 void
 WorkspaceTabBar::stopProgress(int inIndex)
 {
-//	QWidget* theButton = tabButton(inIndex, QTabBar::LeftSide);
-//	if (theButton == NULL)
-//		return;
+    if (!mProgressPanels.remove(mParent->widget(inIndex)))
+        return;
+
+    const ButtonPosition theSides[] = { QTabBar::LeftSide, QTabBar::RightSide };
+    for (int index = 0; index < 2; ++index) {
+        QWidget* theSpacer = tabButton(inIndex, theSides[index]);
+        if (theSpacer != NULL && theSpacer->objectName() == kProgressIndicatorName) {
+            setTabButton(inIndex, theSides[index], NULL);
+            theSpacer->deleteLater();
+        }
+    }
+
+    if (mProgressPanels.isEmpty())
+        ProgressClock::instance()->detach(this);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::isProgressActive()
+//-----------------------------------------------------------------------------
+bool
+WorkspaceTabBar::isProgressActive(int inIndex) const
+{
+    return mProgressPanels.contains(mParent->widget(inIndex));
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::pruneProgress()
+//
+/// Forget the progress of panels that are no longer tabs of this bar.
+//-----------------------------------------------------------------------------
+void
+WorkspaceTabBar::pruneProgress()
+{
+    if (mProgressPanels.isEmpty())
+        return;
+
+    QMutableSetIterator<QWidget*> iter(mProgressPanels);
+    while (iter.hasNext()) {
+        if (mParent->indexOf(iter.next()) == -1)
+            iter.remove();
+    }
+
+    if (mProgressPanels.isEmpty())
+        ProgressClock::instance()->detach(this);
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::onProgressTick() [slot]
+//
+/// Repaint only the indicators that can actually be seen.
+/// \param inPhase The phase of the shared progress clock.
+//-----------------------------------------------------------------------------
+void
+WorkspaceTabBar::onProgressTick(int inPhase)
+{
+    Q_UNUSED(inPhase);
+
+    if (!isVisible() || window()->isMinimized())
+        return;
+
+    const QRegion theVisibleRegion = visibleRegion();
+    Q_FOREACH(QWidget* thePanel, mProgressPanels) {
+        const QRect theRect = getProgressRect(mParent->indexOf(thePanel));
+        if (!theRect.isEmpty() && theVisibleRegion.intersects(theRect))
+            update(theRect);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::getProgressSide()
+//
+/// The progress indicator goes on the side opposite the close button.
+//-----------------------------------------------------------------------------
+QTabBar::ButtonPosition
+WorkspaceTabBar::getProgressSide() const
+{
+    const ButtonPosition closeSide = 
+        (ButtonPosition)style()->styleHint(QStyle::SH_TabBar_CloseButtonPosition, 
+                                           0, 
+                                           this);
+
+    return closeSide == QTabBar::LeftSide ? QTabBar::RightSide : QTabBar::LeftSide;
+}
+
+
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::getProgressRect()
 //
-//	workspace::SyncButton* syncButton =
-//		qobject_cast<workspace::SyncButton*>(theButton);
-//	if (syncButton == NULL)
-//		return;
-//		
-//	syncButton->stop();
-//	syncButton->hide();	
+/// Get where the indicator of a busy tab is drawn. That is the slot
+/// reserved for it, or beside the button opposite the close button when
+/// the tab has buttons in both slots.
+/// \param inIndex The tab.
+/// \result The indicator rect of the tab, or an empty rect.
+//-----------------------------------------------------------------------------
+QRect
+WorkspaceTabBar::getProgressRect(int inIndex) const
+{
+    if (!mProgressPanels.contains(mParent->widget(inIndex)))
+        return QRect();
+
+    const ButtonPosition theSides[] = { QTabBar::LeftSide, QTabBar::RightSide };
+    for (int index = 0; index < 2; ++index) {
+        const QWidget* theSpacer = tabButton(inIndex, theSides[index]);
+        if (theSpacer != NULL && theSpacer->objectName() == kProgressIndicatorName)
+            return theSpacer->geometry();
+    }
+
+    const ButtonPosition theSide = getProgressSide();
+    const QWidget* theButton = tabButton(inIndex, theSide);
+    if (theButton == NULL)
+        return QRect();
+
+    const QRect theButtonRect = theButton->geometry();
+    QRect theRect(0, 0, kProgressSize, kProgressSize);
+    theRect.moveCenter(theButtonRect.center());
+    if (theSide == QTabBar::LeftSide)
+        theRect.moveLeft(theButtonRect.right() + 1 + kProgressSpacing);
+    else
+        theRect.moveRight(theButtonRect.left() - 1 - kProgressSpacing);
+
+    return theRect;
 }
 
 
+//-----------------------------------------------------------------------------
+// WorkspaceTabBar::drawProgress()
+//
+/// Draw a spinning busy indicator.
+/// \param inPainter The painter.
+/// \param inRect The indicator rect.
+/// \param inPhase The leading spoke.
+//-----------------------------------------------------------------------------
+void
+WorkspaceTabBar::drawProgress(QPainter& inPainter, const QRect& inRect, int inPhase) const
+{
+    const int theCount = ProgressClock::PhaseCount;
+    const qreal theOuter = inRect.width() / 2.0;
+    const qreal theInner = theOuter * 0.45;
+
+    inPainter.save();
+    inPainter.setRenderHint(QPainter::Antialiasing);
+    inPainter.translate(QRectF(inRect).center());
+
+    QColor theColor = palette().color(QPalette::WindowText);
+    for (int spoke = 0; spoke < theCount; ++spoke) {
+        // Spokes fade out behind the leading one
+        const int theAge = (inPhase - spoke + theCount) % theCount;
+        theColor.setAlphaF(1.0 - theAge / qreal(theCount));
+        inPainter.setPen(QPen(theColor, 1.5, Qt::SolidLine, Qt::RoundCap));
+        inPainter.drawLine(QPointF(0, -theInner), QPointF(0, -theOuter));
+        inPainter.rotate(360.0 / theCount);
+    }
+
+    inPainter.restore();
+}
+
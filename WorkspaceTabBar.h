@@ -22,9 +22,11 @@ THE SOFTWARE.
 #define WORKSPACETABBAR_HAS_BEEN_INCLUDED
 
 // Qt
+#include <QSet>
 #include <QTabBar>
 
 // Forward declarations
+class QPainter;
 class WorkspacePanelGroup;
 
 //=============================================================================
@@ -40,9 +42,12 @@ public:
 
     void setActivePanel(int inIndex);
     void setActive(bool inActive);
+    void updateActiveOutline();
 
     void startProgress(int inIndex);
     void stopProgress(int inIndex);
+    bool isProgressActive(int inIndex) const;
+    QRect getProgressRect(int inIndex) const;
 
 public Q_SLOTS:
     void onTabChanged(int inIndex);
@@ -57,13 +62,23 @@ protected:
     virtual void mouseDoubleClickEvent(QMouseEvent* inEvent);
 	virtual void leaveEvent(QEvent* inEvent);
 	virtual void paintEvent(QPaintEvent* inEvent);
-    virtual void timerEvent(QTimerEvent* inEvent);
+
+private Q_SLOTS:
+    void onProgressTick(int inPhase);
+    void onDragSettled();
     
 private:
+    QRegion getActiveOutlineRegion() const;
+    ButtonPosition getProgressSide() const;
+    void drawProgress(QPainter& inPainter, const QRect& inRect, int inPhase) const;
+    void pruneProgress();
+
     WorkspacePanelGroup* mParent;
     int mHoverIndex;
 	bool mDragging;
 	bool mActive;
+    int mSettleTaskId;
+    QSet<QWidget*> mProgressPanels;
 };
 
 
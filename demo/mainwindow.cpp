@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include <QtWidgets>
 
 // Local
+#include "defaultWorkspace_layout.h"
 #include "mainwindow.h"
 #include "../Workspace.h"
 #include "../WorkspaceArea.h"
@@ -110,11 +111,6 @@ MainWindow::init()
 #if 1
     // Get the user state files
     QFile stateFile("./workspace.conf");
-    if (!stateFile.exists()) {
-        // Try to use the defaults
-        stateFile.setFileName(":defaultWorkspace");
-    }
-        
 	if (stateFile.exists()) {
 
         stateFile.open(QIODevice::ReadOnly | QIODevice::Text);
@@ -174,43 +170,36 @@ MainWindow::init()
     } else
 #endif
 {
-#if 0
-        const bool BEFORE = true;
-        const bool AFTER = !BEFORE;
-
-        // Initialize state
-        WorkspacePanel* panelOne = getNewPanel("One");
-        WorkspacePanel* panelTwo = getNewPanel("Two");
-        WorkspacePanel* panelThree = getNewPanel("Three");
-        WorkspacePanel* panelFour = getNewPanel("Four");
-        WorkspacePanel* panelFive = getNewPanel("Five");
-        WorkspacePanel* panelSix = getNewPanel("Six");
-        WorkspacePanel* panelSeven = getNewPanel("Seven");
-        WorkspacePanel* panelEight = getNewPanel("Eight");
-
-        workspaceArea->addPanel(panelOne, Qt::Horizontal);
-        workspaceArea->insertPanel(panelOne, panelTwo    , Qt::Horizontal, AFTER);
-
-        workspaceArea->insertPanel(panelOne, panelThree,  Qt::Vertical  , AFTER);
-        workspaceArea->insertPanel(panelThree, panelFour  , Qt::Horizontal, AFTER);
-
-        workspaceArea->insertPanel(panelOne, panelFive ,   Qt::Horizontal, AFTER);
-        workspaceArea->insertPanel(panelFive , panelSix     ,   Qt::Horizontal, AFTER);
-        //workspaceArea->insertPanel(panelOne,      waterfall, Qt::Horizontal, AFTER);
-
-        workspaceArea->addToPanelGroup(panelFive, panelSeven);
-        workspaceArea->addToPanelGroup(panelFive , panelEight);
-#else
-		// Simpler layout for testing.
-        WorkspacePanel* panelOne = getNewPanel("One");
-        workspaceArea->addPanel(panelOne, Qt::Horizontal);
-
-        WorkspacePanel* panelTwo = getNewPanel("Two");
-        workspaceArea->addPanel(panelTwo, Qt::Horizontal);
-
-        WorkspacePanel* panelThree = getNewPanel("Three");
-        workspaceArea->addPanel(panelThree, Qt::Horizontal);
-#endif
+        // Use the default layout compiled into the demo
+        const EmbeddedLayout& theLayout = kDefaultWorkspaceLayout;
+
+        WorkspaceLayout* workspaceLayout = qobject_cast<WorkspaceLayout*>(workspaceArea->layout());
+
+        // Create the panel groups and panels
+        for (int groupIndex = 0; groupIndex < theLayout.groupCount; ++groupIndex) {
+            const EmbeddedPanelGroup& layoutData = theLayout.groups[groupIndex];
+            if (layoutData.panelCount == 0)
+                continue;
+
+            WorkspacePanel* groupPanel = getNewPanel(QString::fromUtf8(layoutData.panels[0]));
+            workspaceArea->addPanel(groupPanel, Qt::Horizontal);
+
+            for (int panelIndex = 1; panelIndex < layoutData.panelCount; ++panelIndex) {
+                WorkspacePanel* thePanel = getNewPanel(QString::fromUtf8(layoutData.panels[panelIndex]));
+                workspaceArea->addToPanelGroup(groupPanel, thePanel);
+            }
+
+            // Set the active panel and the grid position of the group
+            WorkspacePanelGroup* panelGroup = workspaceLayout->findPanelGroup(groupPanel);
+            panelGroup->setCurrentIndex(layoutData.active);
+            panelGroup->setConstraints(layoutData.gridx, 
+                                       layoutData.gridy, 
+                                       layoutData.gridwidth, 
+                                       layoutData.gridheight);
+        }
+
+        workspaceArea->setLayoutName(QString::fromUtf8(theLayout.name));
+        workspaceArea->restoreComplete();
     }
     
     workspaceArea->endDeferLayout();
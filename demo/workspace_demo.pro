@@ -1,6 +1,6 @@
 CONFIG += qt
 
-QT += core gui widgets
+QT += core gui widgets concurrent
 
 INCLUDEPATH += ../
 
@@ -9,9 +9,17 @@ DEFINES += Q_WS_MAC
 SOURCES += \
     mainwindow.cpp \
     main.cpp \
+    ../AnimationMonitor.cc \
     ../DynamicGraphicsItems.cc \
     ../DynamicGridLayout.cc \    
+    ../FloatingWindowPool.cc \
     ../LayoutEngine.cc \
+    ../LayoutLibrary.cc \
+    ../PluginCatalog.cc \
+    ../ProgressClock.cc \
+    ../RenderingProfile.cc \
+    ../TaskScheduler.cc \
+    ../UpdateScheduler.cc \
     ../WidgetAnimator.cc \
     ../Workspace.cc \
     ../WorkspaceArea.cc \
@@ -26,8 +34,17 @@ SOURCES += \
 
 HEADERS += \
     mainwindow.h \
+    ../AnimationMonitor.h \
     ../DynamicGraphicsItems.h \
     ../DynamicGridLayout.h \    
+    ../EmbeddedLayout.h \
+    ../FloatingWindowPool.h \
+    ../LayoutLibrary.h \
+    ../PluginCatalog.h \
+    ../ProgressClock.h \
+    ../RenderingProfile.h \
+    ../TaskScheduler.h \
+    ../UpdateScheduler.h \
     ../WidgetAnimator.h \
     ../Workspace.h \
     ../WorkspaceArea.h \
@@ -42,6 +59,17 @@ HEADERS += \
     
 RESOURCES =	workspace_demo.qrc			\
 
+# Compile the default layout into the demo
+EMBEDDED_LAYOUTS = defaultWorkspace
+
+embed_layout.input = EMBEDDED_LAYOUTS
+embed_layout.output = ${QMAKE_FILE_BASE}_layout.h
+embed_layout.commands = python $$PWD/../tools/embed_layout.py ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+embed_layout.depends = $$PWD/../tools/embed_layout.py
+embed_layout.CONFIG += no_link target_predeps
+QMAKE_EXTRA_COMPILERS += embed_layout
+INCLUDEPATH += $$OUT_PWD
+
 OBJECTS_DIR = ./obj
 
 MOC_DIR = ./moc
@@ -22,14 +22,147 @@ THE SOFTWARE.
 #include "FrameworkStyle.h"
 
 // Qt
+#include <QApplication>
 #include <QDebug>
+#include <QEvent>
 #include <QPainter>
+#include <QPainterPath>
+#include <QPixmapCache>
 #include <QStyleOption>
+#include <QTabBar>
 #include <QVarLengthArray>
 
+// Local
+#include "../RenderingProfile.h"
+
 // Namespaces
 using namespace workspace;
 
+namespace {
+
+// Constants
+
+/// A stop of a gray gradient in the studio theme
+struct GrayStop {
+    qreal position;     ///< Position along the gradient, from 0 to 1
+    int level;          ///< Gray level at the position
+};
+
+// Gradients of the studio theme
+static const GrayStop kButtonStops[] = { {0.0, 230}, {0.1, 188}, {0.9, 146}, {1.0, 180} };
+static const GrayStop kButtonPressedStops[] = { {0.0, 80}, {0.1, 150}, {0.9, 150}, {1.0, 80} };
+static const GrayStop kCheckStops[] = { {0.0, 240}, {0.2, 188}, {0.85, 146}, {1.0, 180} };
+static const GrayStop kHeaderStops[] = { {0.0, 220}, {0.1, 182}, {0.9, 158}, {1.0, 114} };
+static const GrayStop kKnobStops[] = { {0.0, 240}, {0.3, 188}, {0.8, 146}, {1.0, 180} };
+static const GrayStop kMenuBarStops[] = { {0.0, 211}, {1.0, 169} };
+static const GrayStop kScrollHandleStops[] = { {0.0, 200}, {0.1, 179}, {0.9, 141}, {1.0, 80} };
+static const GrayStop kScrollPageStops[] = { {0.0, 90}, {0.9, 117}, {1.0, 160} };
+static const GrayStop kSliderGrooveStops[] = { {0.0, 100}, {1.0, 140} };
+static const GrayStop kTabStops[] = { {0.0, 20}, {0.1, 120}, {0.13, 130}, {0.14, 140}, {0.9, 140}, {1.0, 100} };
+static const GrayStop kTabSelectedStops[] = { {0.0, 230}, {0.55, 170}, {0.6, 156}, {1.0, 156} };
+
+// Flat grays of the studio theme
+static const int kWindowGray = 156;
+static const int kBaseGray = 230;
+static const int kViewGray = 194;
+static const int kTextGray = 25;
+static const int kDisabledTextGray = 114;
+static const int kHighlightGray = 169;
+static const int kListHighlightGray = 87;
+static const int kListHighlightedTextGray = 192;
+static const int kButtonBorderGray = 97;
+static const int kFrameBorderGray = 114;
+static const int kPaneBorderGray = 80;
+static const int kTabBorderGray = 200;
+static const int kHeaderLightGray = 157;
+static const int kScrollBorderGray = 92;
+static const int kScrollPressedGray = 80;
+static const int kDisabledFillGray = 174;
+static const int kDisabledBorderGray = 141;
+static const int kDisabledPageGray = 137;
+
+// Metrics of the studio theme
+static const int kFrameRadius = 3;
+static const int kScrollRadius = 2;
+static const int kTabRadius = 6;
+static const int kTabHeight = 24;
+static const int kTabMinWidthEx = 8;
+static const int kTabHSpace = 6;
+static const int kScrollBarExtent = 15;
+static const int kIndicatorSize = 14;
+static const int kLabelSpacing = 5;
+static const int kSliderLength = 14;
+static const int kSliderThickness = 18;
+static const int kSliderGrooveWidth = 6;
+static const int kSeparatorExtent = 5;
+static const int kComboArrowWidth = 25;
+static const int kComboTextMargin = 10;
+static const int kComboMinWidth = 50;
+static const int kComboMinHeight = 20;
+
+// Palette changes held back from hidden widgets during a theme switch
+static const int kDeferredApplicationPalette = 0x1;
+static const int kDeferredPalette = 0x2;
+
+
+//-----------------------------------------------------------------------------
+// gray()
+//
+/// Return the gray of the given level
+//-----------------------------------------------------------------------------
+static inline QColor
+gray(int level)
+{
+    return QColor(level, level, level);
+}
+
+
+//-----------------------------------------------------------------------------
+// grayBrush()
+//
+/// Return a gradient across the rectangle, or a flat fill of its middle
+/// stop when gradients are disabled
+//-----------------------------------------------------------------------------
+template <int Count>
+static QBrush
+grayBrush(const QRect& rect, 
+          Qt::Orientation orientation, 
+          const GrayStop (&stops)[Count],
+          bool gradient)
+{
+    if (!gradient)
+        return gray(stops[Count / 2].level);
+
+    QLinearGradient fill(rect.topLeft(),
+                         orientation == Qt::Vertical ? rect.bottomLeft() : rect.topRight());
+    for (int index = 0; index < Count; ++index)
+        fill.setColorAt(stops[index].position, gray(stops[index].level));
+    return fill;
+}
+
+
+//-----------------------------------------------------------------------------
+// drawRoundedPanel()
+//
+/// Draw a rectangle with rounded corners and a one pixel border
+//-----------------------------------------------------------------------------
+static void
+drawRoundedPanel(QPainter* painter, 
+                 const QRect& rect, 
+                 qreal radius, 
+                 const QBrush& fill, 
+                 const QColor& border)
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, radius > 0);
+    painter->setPen(border);
+    painter->setBrush(fill);
+    painter->drawRoundedRect(QRectF(rect).adjusted(0.5, 0.5, -0.5, -0.5), radius, radius);
+    painter->restore();
+}
+
+} // namespace
+
 //=============================================================================
 // class FrameworkStyle
 //=============================================================================
@@ -38,13 +171,31 @@ using namespace workspace;
 // FrameworkStyle::FrameworkStyle()
 //-----------------------------------------------------------------------------
 
-FrameworkStyle::FrameworkStyle()
+FrameworkStyle::FrameworkStyle(Appearance appearance)
+    :   mAppearance(appearance)
+    ,   mGradientsEnabled(true)
+    ,   mPixmapCacheEnabled(true)
+    ,   mPaletteGeneration(0)
+    ,   mSwitchingTheme(false)
 {
     setObjectName("FrameworkStyle");
 
+    if (mAppearance == AppearanceStudio)
+        mThemePalette = studioPalette();
+    else
+        mThemePalette = generatePalette(240, 16, 125, 50);
+
     // Load in the icons
     mBranchOpenIcon.load(QString::fromUtf8(":/themes/normal/icons/branch-open-default.png"));
     mBranchClosedIcon.load(QString::fromUtf8(":/themes/normal/icons/branch-closed-default.png"));
+
+    if (mAppearance == AppearanceStudio) {
+        mAddLineHorzIcon.load(QString::fromUtf8(":/themes/normal/icons/addline-horz.png"));
+        mAddLineVertIcon.load(QString::fromUtf8(":/themes/normal/icons/addline-vert.png"));
+        mSubLineHorzIcon.load(QString::fromUtf8(":/themes/normal/icons/subline-horz.png"));
+        mSubLineVertIcon.load(QString::fromUtf8(":/themes/normal/icons/subline-vert.png"));
+        mComboArrowIcon.load(QString::fromUtf8(":/themes/normal/icons/combo-arrow.png"));
+    }
 }
 
 
@@ -131,12 +282,198 @@ FrameworkStyle::generatePalette(int hue, int sat, int val, int contrast) const
     return pal;
 }
 
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::setGradientsEnabled()
+//
+/// Choose between gradient and flat fills for buttons and header
+/// sections. Flat fills compress far better over X forwarding and VNC.
+/// Widgets are not repainted, the caller does that.
+/// \sa drawsGradients
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::setGradientsEnabled(bool enabled)
+{
+    mGradientsEnabled = enabled;
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::setPixmapCacheEnabled()
+//
+/// Choose whether buttons, header sections and tabs are drawn once into
+/// the QPixmapCache and blitted afterwards, or drawn on every paint.
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::setPixmapCacheEnabled(bool enabled)
+{
+    mPixmapCacheEnabled = enabled;
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawsGradients()
+//
+/// Return true if fills are drawn as gradients: this style enables them
+/// and the application is not in the low bandwidth rendering profile. The
+/// profile is read while painting, so it applies to every style instance.
+//-----------------------------------------------------------------------------
+bool
+FrameworkStyle::drawsGradients() const
+{
+    return mGradientsEnabled && !RenderingProfile::instance()->isLowBandwidth();
+}
+
+
 //-----------------------------------------------------------------------------
 // FrameworkStyle::standardPalette()
 //-----------------------------------------------------------------------------
 QPalette FrameworkStyle::standardPalette() const
 {
-    return generatePalette(240, 16, 125, 50);
+    return mThemePalette;
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::setThemePalette()
+//
+/// Switch themes without setStyle(). Nothing is unpolished or laid out
+/// again: the application palette is replaced, visible widgets repaint
+/// with it and cached primitives of older palettes are no longer hit.
+/// Hidden widgets get their palette change when they are next shown.
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::setThemePalette(const QPalette& palette)
+{
+    mThemePalette = palette;
+    ++mPaletteGeneration;
+
+    if (mDeferredChanges.isEmpty())
+        qApp->installEventFilter(this);
+
+    mSwitchingTheme = true;
+    QApplication::setPalette(palette);
+    if (mAppearance == AppearanceStudio)
+        setViewPalettes(palette);
+    mSwitchingTheme = false;
+
+    if (mDeferredChanges.isEmpty())
+        qApp->removeEventFilter(this);
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::setThemeColors()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::setThemeColors(int hue, int sat, int val, int contrast)
+{
+    setThemePalette(generatePalette(hue, sat, val, contrast));
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::eventFilter()
+//
+/// While a theme is switched, palette change events for hidden widgets
+/// are held back, and replayed when the widget is shown.
+//-----------------------------------------------------------------------------
+bool
+FrameworkStyle::eventFilter(QObject* watched, QEvent* event)
+{
+    switch (event->type()) {
+
+        case QEvent::ApplicationPaletteChange:
+        case QEvent::PaletteChange:
+        {
+            if (!mSwitchingTheme || !watched->isWidgetType() || static_cast<QWidget*>(watched)->isVisible())
+                break;
+
+            if (!mDeferredChanges.contains(watched))
+                connect(watched, SIGNAL(destroyed(QObject*)), SLOT(onDeferredWidgetDestroyed(QObject*)));
+
+            mDeferredChanges[watched] |= event->type() == QEvent::PaletteChange 
+                                       ? kDeferredPalette 
+                                       : kDeferredApplicationPalette;
+            return true;
+        }
+
+        case QEvent::Show:
+        {
+            QHash<QObject*, int>::iterator found = mDeferredChanges.find(watched);
+            if (found == mDeferredChanges.end())
+                break;
+
+            const int changes = found.value();
+            mDeferredChanges.erase(found);
+            disconnect(watched, SIGNAL(destroyed(QObject*)), this, SLOT(onDeferredWidgetDestroyed(QObject*)));
+
+            if (changes & kDeferredApplicationPalette) {
+                QEvent change(QEvent::ApplicationPaletteChange);
+                QApplication::sendEvent(watched, &change);
+            }
+
+            if (changes & kDeferredPalette) {
+                QEvent change(QEvent::PaletteChange);
+                QApplication::sendEvent(watched, &change);
+            }
+
+            if (mDeferredChanges.isEmpty() && !mSwitchingTheme)
+                qApp->removeEventFilter(this);
+        }
+        break;
+
+        default:
+            break;
+    }
+
+    return QCommonStyle::eventFilter(watched, event);
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::onDeferredWidgetDestroyed()                         [slot]
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::onDeferredWidgetDestroyed(QObject* widget)
+{
+    mDeferredChanges.remove(widget);
+
+    if (mDeferredChanges.isEmpty() && !mSwitchingTheme)
+        qApp->removeEventFilter(this);
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::studioPalette()
+//
+/// The colors of the studio theme. Item views get lighter variants of
+/// it in polish(QApplication*).
+//-----------------------------------------------------------------------------
+QPalette
+FrameworkStyle::studioPalette()
+{
+    QPalette palette(gray(kWindowGray));
+
+    palette.setColor(QPalette::Window, gray(kWindowGray));
+    palette.setColor(QPalette::WindowText, Qt::black);
+    palette.setColor(QPalette::Button, gray(kWindowGray));
+    palette.setColor(QPalette::ButtonText, Qt::black);
+    palette.setColor(QPalette::Base, gray(kBaseGray));
+    palette.setColor(QPalette::AlternateBase, gray(kViewGray));
+    palette.setColor(QPalette::Text, gray(kTextGray));
+    palette.setColor(QPalette::Light, gray(kTabBorderGray));
+    palette.setColor(QPalette::Mid, gray(kFrameBorderGray));
+    palette.setColor(QPalette::Dark, gray(kButtonBorderGray));
+    palette.setColor(QPalette::Shadow, gray(kPaneBorderGray));
+    palette.setColor(QPalette::Highlight, gray(kHighlightGray));
+    palette.setColor(QPalette::HighlightedText, Qt::black);
+
+    palette.setColor(QPalette::Disabled, QPalette::WindowText, gray(kDisabledTextGray));
+    palette.setColor(QPalette::Disabled, QPalette::ButtonText, gray(kDisabledTextGray));
+    palette.setColor(QPalette::Disabled, QPalette::Text, gray(kDisabledTextGray));
+
+    return palette;
 }
 
 
@@ -157,9 +494,29 @@ void
 FrameworkStyle::polish(QApplication* application)
 {
     QCommonStyle::polish(application);
+
+    if (mAppearance == AppearanceStudio)
+        setViewPalettes(mThemePalette);
 }    
 
 
+//-----------------------------------------------------------------------------
+// FrameworkStyle::setViewPalettes()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::setViewPalettes(const QPalette& palette)
+{
+    // Item views are lighter than the window, and lists select in dark gray
+    QPalette viewPalette = palette;
+    viewPalette.setColor(QPalette::Base, palette.color(QPalette::AlternateBase));
+    QApplication::setPalette(viewPalette, "QTreeView");
+
+    viewPalette.setColor(QPalette::Highlight, gray(kListHighlightGray));
+    viewPalette.setColor(QPalette::HighlightedText, gray(kListHighlightedTextGray));
+    QApplication::setPalette(viewPalette, "QListView");
+}
+
+
 //-----------------------------------------------------------------------------
 // FrameworkStyle::polish()
 //-----------------------------------------------------------------------------
@@ -199,76 +556,16 @@ FrameworkStyle::drawPrimitive(PrimitiveElement element,
                            QPainter* painter, 
                            const QWidget* widget) const
 {
+    if (mAppearance == AppearanceStudio && drawStudioPrimitive(element, option, painter, widget))
+        return;
+
     switch (element) {
 
         case PE_PanelButtonCommand:
-        {
-            painter->save();
-
-            const bool enabled = option->state & State_Enabled;
-            QRect bounds = option->rect;
-
-            painter->setBrush(Qt::NoBrush);
-
-            if (enabled) {
-                // Draw outline shadows
-                painter->setPen(option->palette.window().color().lighter(110));
-                painter->drawLine(bounds.bottomLeft(), bounds.bottomRight());
-                painter->drawLine(bounds.topRight(), bounds.bottomRight());
-            }
-
-            // Draw outline
-            painter->setPen(Qt::black);
-            bounds = option->rect;
-            bounds.setRight(bounds.right() - 2);
-            bounds.setBottom(bounds.bottom() - 2);
-            painter->drawRect(bounds);
-
-            // Paint the gradient
-            QColor startColor;
-            QColor midColor;
-            QColor bandColor;
-            QColor stopColor;
-
-            if (enabled) {
-                if (option->state & (State_Sunken | State_On)) {
-                    startColor = option->palette.window().color().lighter(110);
-                    midColor = option->palette.window().color().lighter(115);
-                    bandColor = option->palette.window().color().darker(105);
-                    stopColor = option->palette.window().color().darker(125);
-                } else {
-                    startColor = option->palette.window().color().lighter(100);
-                    midColor = option->palette.window().color().lighter(105);
-                    bandColor = option->palette.window().color().darker(110);
-                    stopColor = option->palette.window().color().darker(135);
-                }
-            } else {
-                startColor = option->palette.window().color().darker(150);
-                midColor = option->palette.window().color().darker(155);
-                bandColor = option->palette.window().color().darker(160);
-                stopColor = option->palette.window().color().darker(170);
-            }
-
-            QRect gradientRect = bounds.adjusted(1, 1, 0, 0);
-            QLinearGradient gradient(gradientRect.topRight(), gradientRect.bottomRight());
-
-            gradient.setColorAt(0, startColor );
-            gradient.setColorAt(0.5, midColor );
-            gradient.setColorAt(0.51, bandColor );
-            gradient.setColorAt(1, stopColor );
-            painter->fillRect(gradientRect, gradient);
-
-            if (enabled) {
-                // Draw highlight
-                QRect highlightRect = gradientRect.adjusted(0, 0, -1, -1);
-                painter->setPen(option->palette.window().color().lighter(120));
-                painter->drawLine(highlightRect.topLeft(), highlightRect.bottomLeft());
-                painter->drawLine(highlightRect.topRight(), highlightRect.topLeft());
-            }
-
-            painter->restore();
-        }
-        break;
+            drawCached("button", 
+                       option->state & (State_Enabled | State_Sunken | State_On), 
+                       option, painter, widget, &FrameworkStyle::drawButtonPanel);
+            break;
 
 
         case PE_IndicatorBranch:
@@ -312,6 +609,9 @@ FrameworkStyle::drawControl(ControlElement element,
                          QPainter* painter, 
                          const QWidget* widget) const
 {
+    if (mAppearance == AppearanceStudio && drawStudioControl(element, option, painter, widget))
+        return;
+
     switch (element) {
 
         case CE_ColumnViewGrip:
@@ -375,46 +675,8 @@ FrameworkStyle::drawControl(ControlElement element,
         break;
 
         case CE_HeaderSection:
-        {
-            painter->save();
-
-            // Get the rect to frame
-            QRect frameRect = option->rect;
-
-            // Fill the background
-            QLinearGradient gradient(frameRect.topLeft(), frameRect.bottomLeft());
-            gradient.setColorAt(0.0, option->palette.brush(QPalette::Window).color().lighter(115));
-            gradient.setColorAt(1.0, option->palette.brush(QPalette::Window).color().darker(110));
-            painter->fillRect(frameRect, QBrush(gradient));
-
-            // Draw the highlight
-            QPoint highLeft = frameRect.topLeft();
-            QPoint highRight = frameRect.topLeft();
-            highRight.setX(highRight.x() + 1);
-            painter->setPen(option->palette.light().color().darker(150));
-            painter->drawLine(highLeft, highRight);
-
-            QPoint topLeft = frameRect.topLeft();
-            painter->setPen(option->palette.light().color().darker(100));
-            topLeft.setX(topLeft.x() + 2);
-            painter->drawLine(topLeft, frameRect.topRight());
-
-            // Draw the shadow
-            painter->setPen(option->palette.dark().color().lighter(115));
-            topLeft = frameRect.topLeft();
-            topLeft.setY(topLeft.y() + 1);
-            painter->drawLine(topLeft, frameRect.bottomLeft());
-            painter->drawLine(frameRect.bottomLeft(), frameRect.bottomRight());
-
-            // Draw the separators
-            painter->setPen(option->palette.light().color());
-            QPoint bottomRight = frameRect.bottomRight();
-            bottomRight.setY(bottomRight.y() - 1);
-            painter->drawLine(frameRect.topRight(), bottomRight);
-                        
-            painter->restore();
-        }
-        break;
+            drawCached("header", 0, option, painter, widget, &FrameworkStyle::drawHeaderSection);
+            break;
 
         case CE_PushButton:
         {
@@ -478,6 +740,22 @@ FrameworkStyle::drawControl(ControlElement element,
         }
         break;
 
+        case CE_TabBarTabShape:
+        {
+            const QStyleOptionTab* tab = qstyleoption_cast<const QStyleOptionTab *>(option);
+            if (tab != NULL) {
+                const quint64 variant = quint64(tab->state)
+                                      | quint64(tab->shape) << 32
+                                      | quint64(tab->position) << 40
+                                      | quint64(tab->selectedPosition) << 48
+                                      | quint64(tab->direction) << 56;
+                drawCached("tab", variant, tab, painter, widget, &FrameworkStyle::drawTabShape);
+            } else {
+                QCommonStyle::drawControl(element, option, painter, widget);
+            }
+        }
+        break;
+
 #if 0
         case CE_TabBarTabShape:
         {
@@ -938,6 +1216,720 @@ FrameworkStyle::drawControl(ControlElement element,
 }
 
 
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawButtonPanel()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawButtonPanel(const QStyleOption* option,
+                                QPainter* painter,
+                                const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    painter->save();
+
+    const bool enabled = option->state & State_Enabled;
+    QRect bounds = option->rect;
+
+    painter->setBrush(Qt::NoBrush);
+
+    if (enabled) {
+        // Draw outline shadows
+        painter->setPen(option->palette.window().color().lighter(110));
+        painter->drawLine(bounds.bottomLeft(), bounds.bottomRight());
+        painter->drawLine(bounds.topRight(), bounds.bottomRight());
+    }
+
+    // Draw outline
+    painter->setPen(Qt::black);
+    bounds = option->rect;
+    bounds.setRight(bounds.right() - 2);
+    bounds.setBottom(bounds.bottom() - 2);
+    painter->drawRect(bounds);
+
+    // Paint the gradient
+    QColor startColor;
+    QColor midColor;
+    QColor bandColor;
+    QColor stopColor;
+
+    if (enabled) {
+        if (option->state & (State_Sunken | State_On)) {
+            startColor = option->palette.window().color().lighter(110);
+            midColor = option->palette.window().color().lighter(115);
+            bandColor = option->palette.window().color().darker(105);
+            stopColor = option->palette.window().color().darker(125);
+        } else {
+            startColor = option->palette.window().color().lighter(100);
+            midColor = option->palette.window().color().lighter(105);
+            bandColor = option->palette.window().color().darker(110);
+            stopColor = option->palette.window().color().darker(135);
+        }
+    } else {
+        startColor = option->palette.window().color().darker(150);
+        midColor = option->palette.window().color().darker(155);
+        bandColor = option->palette.window().color().darker(160);
+        stopColor = option->palette.window().color().darker(170);
+    }
+
+    QRect gradientRect = bounds.adjusted(1, 1, 0, 0);
+    if (drawsGradients()) {
+        QLinearGradient gradient(gradientRect.topRight(), gradientRect.bottomRight());
+
+        gradient.setColorAt(0, startColor );
+        gradient.setColorAt(0.5, midColor );
+        gradient.setColorAt(0.51, bandColor );
+        gradient.setColorAt(1, stopColor );
+        painter->fillRect(gradientRect, gradient);
+    } else {
+        painter->fillRect(gradientRect, midColor);
+    }
+
+    if (enabled) {
+        // Draw highlight
+        QRect highlightRect = gradientRect.adjusted(0, 0, -1, -1);
+        painter->setPen(option->palette.window().color().lighter(120));
+        painter->drawLine(highlightRect.topLeft(), highlightRect.bottomLeft());
+        painter->drawLine(highlightRect.topRight(), highlightRect.topLeft());
+    }
+
+    painter->restore();
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawHeaderSection()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawHeaderSection(const QStyleOption* option,
+                                  QPainter* painter,
+                                  const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    painter->save();
+
+    // Get the rect to frame
+    QRect frameRect = option->rect;
+
+    // Fill the background
+    if (drawsGradients()) {
+        QLinearGradient gradient(frameRect.topLeft(), frameRect.bottomLeft());
+        gradient.setColorAt(0.0, option->palette.brush(QPalette::Window).color().lighter(115));
+        gradient.setColorAt(1.0, option->palette.brush(QPalette::Window).color().darker(110));
+        painter->fillRect(frameRect, QBrush(gradient));
+    } else {
+        painter->fillRect(frameRect, option->palette.brush(QPalette::Window));
+    }
+
+    // Draw the highlight
+    QPoint highLeft = frameRect.topLeft();
+    QPoint highRight = frameRect.topLeft();
+    highRight.setX(highRight.x() + 1);
+    painter->setPen(option->palette.light().color().darker(150));
+    painter->drawLine(highLeft, highRight);
+
+    QPoint topLeft = frameRect.topLeft();
+    painter->setPen(option->palette.light().color().darker(100));
+    topLeft.setX(topLeft.x() + 2);
+    painter->drawLine(topLeft, frameRect.topRight());
+
+    // Draw the shadow
+    painter->setPen(option->palette.dark().color().lighter(115));
+    topLeft = frameRect.topLeft();
+    topLeft.setY(topLeft.y() + 1);
+    painter->drawLine(topLeft, frameRect.bottomLeft());
+    painter->drawLine(frameRect.bottomLeft(), frameRect.bottomRight());
+
+    // Draw the separators
+    painter->setPen(option->palette.light().color());
+    QPoint bottomRight = frameRect.bottomRight();
+    bottomRight.setY(bottomRight.y() - 1);
+    painter->drawLine(frameRect.topRight(), bottomRight);
+                
+    painter->restore();
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawTabShape()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawTabShape(const QStyleOption* option,
+                             QPainter* painter,
+                             const QWidget* widget) const
+{
+    QCommonStyle::drawControl(CE_TabBarTabShape, option, painter, widget);
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawCached()
+//
+/// Draw an element through the pixmap cache. The element is rendered
+/// once into a pixmap of its size, keyed by the element, the parts of its
+/// state it depends on, its size and the palette, and later paints only
+/// blit the pixmap. Entries of earlier theme palettes are never hit again
+/// and age out of the cache.
+/// \param element The name of the element in the cache keys.
+/// \param variant The options the element's appearance depends on.
+/// \param draw The function that draws the element at option->rect.
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawCached(const char* element,
+                           quint64 variant,
+                           const QStyleOption* option,
+                           QPainter* painter,
+                           const QWidget* widget,
+                           DrawFunction draw) const
+{
+    const QRect& bounds = option->rect;
+    if (!mPixmapCacheEnabled || bounds.isEmpty()) {
+        (this->*draw)(option, painter, widget);
+        return;
+    }
+
+    const int ratio = painter->device() != NULL ? painter->device()->devicePixelRatio() : 1;
+    const QString key = QString::fromLatin1("fws-%1-%2-%3x%4@%5-%6.%7-%8")
+        .arg(QLatin1String(element))
+        .arg(variant)
+        .arg(bounds.width())
+        .arg(bounds.height())
+        .arg(ratio)
+        .arg(mPaletteGeneration)
+        .arg(option->palette.cacheKey())
+        .arg(drawsGradients() ? 1 : 0);
+
+    QPixmap pixmap;
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = QPixmap(bounds.size() * ratio);
+        pixmap.setDevicePixelRatio(ratio);
+        pixmap.fill(Qt::transparent);
+
+        // Draw at the origin of the pixmap
+        QPainter pixmapPainter(&pixmap);
+        pixmapPainter.setRenderHints(painter->renderHints());
+        pixmapPainter.translate(-bounds.topLeft());
+        (this->*draw)(option, &pixmapPainter, widget);
+        pixmapPainter.end();
+
+        QPixmapCache::insert(key, pixmap);
+    }
+
+    painter->drawPixmap(bounds.topLeft(), pixmap);
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioPrimitive()
+//
+/// Draw the primitives the studio theme styles. Everything else is left
+/// to the classic drawing.
+/// \result True if the primitive was drawn.
+//-----------------------------------------------------------------------------
+bool
+FrameworkStyle::drawStudioPrimitive(PrimitiveElement element,
+                                    const QStyleOption* option,
+                                    QPainter* painter,
+                                    const QWidget* widget) const
+{
+    switch (element) {
+
+        case PE_PanelButtonCommand:
+        case PE_PanelButtonTool:
+            drawCached("studio-button",
+                       option->state & (State_Sunken | State_On),
+                       option, painter, widget, &FrameworkStyle::drawStudioButton);
+            return true;
+
+        case PE_IndicatorCheckBox:
+            drawCached("studio-check",
+                       option->state & (State_On | State_NoChange),
+                       option, painter, widget, &FrameworkStyle::drawStudioCheckIndicator);
+            return true;
+
+        case PE_PanelLineEdit:
+        {
+            const QStyleOptionFrame* frame = qstyleoption_cast<const QStyleOptionFrame *>(option);
+            const QBrush& fill = option->palette.brush(QPalette::Base);
+            if (frame != NULL && frame->lineWidth > 0)
+                drawRoundedPanel(painter, option->rect, kFrameRadius, fill, gray(kFrameBorderGray));
+            else
+                painter->fillRect(option->rect, fill);
+        }
+        return true;
+
+        case PE_FrameLineEdit:
+            drawRoundedPanel(painter, option->rect, kFrameRadius, Qt::NoBrush, gray(kFrameBorderGray));
+            return true;
+
+        case PE_Frame:
+        {
+            // List views are square, text edits and trees are rounded
+            const qreal radius = (widget != NULL && widget->inherits("QListView")) ? 0 : kFrameRadius;
+            drawRoundedPanel(painter, option->rect, radius, Qt::NoBrush, gray(kFrameBorderGray));
+        }
+        return true;
+
+        case PE_FrameTabWidget:
+            drawRoundedPanel(painter, option->rect, 0, Qt::NoBrush, gray(kPaneBorderGray));
+            return true;
+
+        case PE_IndicatorDockWidgetResizeHandle:
+            painter->fillRect(option->rect, gray(kWindowGray));
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioControl()
+//
+/// Draw the controls the studio theme styles. Everything else is left
+/// to the classic drawing.
+/// \result True if the control was drawn.
+//-----------------------------------------------------------------------------
+bool
+FrameworkStyle::drawStudioControl(ControlElement element,
+                                  const QStyleOption* option,
+                                  QPainter* painter,
+                                  const QWidget* widget) const
+{
+    const quint64 scrollState = option->state & (State_Enabled | State_Horizontal);
+
+    switch (element) {
+
+        case CE_HeaderSection:
+            drawCached("studio-header", 0, option, painter, widget, &FrameworkStyle::drawStudioHeaderSection);
+            return true;
+
+        case CE_TabBarTabShape:
+        {
+            // Only tabs above their pages have a studio look
+            const QStyleOptionTab* tab = qstyleoption_cast<const QStyleOptionTab *>(option);
+            if (tab == NULL || tab->shape != QTabBar::RoundedNorth)
+                return false;
+
+            drawCached("studio-tab", tab->state & State_Selected,
+                       tab, painter, widget, &FrameworkStyle::drawStudioTabShape);
+        }
+        return true;
+
+        case CE_ScrollBarSlider:
+            drawCached("studio-scroll-slider", scrollState,
+                       option, painter, widget, &FrameworkStyle::drawStudioScrollBarSlider);
+            return true;
+
+        case CE_ScrollBarAddPage:
+        case CE_ScrollBarSubPage:
+            drawCached("studio-scroll-page", scrollState,
+                       option, painter, widget, &FrameworkStyle::drawStudioScrollBarPage);
+            return true;
+
+        case CE_ScrollBarAddLine:
+            drawCached("studio-scroll-add", scrollState | (option->state & State_Sunken),
+                       option, painter, widget, &FrameworkStyle::drawStudioScrollBarAddLine);
+            return true;
+
+        case CE_ScrollBarSubLine:
+            drawCached("studio-scroll-sub", scrollState | (option->state & State_Sunken),
+                       option, painter, widget, &FrameworkStyle::drawStudioScrollBarSubLine);
+            return true;
+
+        case CE_MenuBarEmptyArea:
+            painter->fillRect(option->rect, grayBrush(option->rect, Qt::Vertical, kMenuBarStops, drawsGradients()));
+            return true;
+
+        case CE_MenuBarItem:
+        {
+            const QStyleOptionMenuItem* item = qstyleoption_cast<const QStyleOptionMenuItem *>(option);
+            if (item == NULL)
+                return false;
+
+            // The bar gradient runs on under the items, an open menu darkens its item
+            if (item->state & State_Sunken)
+                painter->fillRect(item->rect, gray(kHighlightGray));
+            else
+                painter->fillRect(item->rect, grayBrush(item->menuRect, Qt::Vertical, kMenuBarStops, drawsGradients()));
+
+            QCommonStyle::drawControl(element, item, painter, widget);
+        }
+        return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioComplexControl()
+//
+/// Draw the complex controls the studio theme styles. Everything else is
+/// left to the classic drawing.
+/// \result True if the control was drawn.
+//-----------------------------------------------------------------------------
+bool
+FrameworkStyle::drawStudioComplexControl(ComplexControl control,
+                                         const QStyleOptionComplex* option,
+                                         QPainter* painter,
+                                         const QWidget* widget) const
+{
+    switch (control) {
+
+        case CC_Slider:
+        {
+            const QStyleOptionSlider* slider = qstyleoption_cast<const QStyleOptionSlider *>(option);
+            if (slider == NULL)
+                return false;
+
+            if (slider->subControls & SC_SliderGroove) {
+                // A thin channel through the middle of the groove area
+                const QRect bounds = subControlRect(control, slider, SC_SliderGroove, widget);
+                const bool horizontal = slider->orientation == Qt::Horizontal;
+
+                QRect groove;
+                if (horizontal)
+                    groove.setRect(bounds.left(), bounds.center().y() - kSliderGrooveWidth / 2,
+                                   bounds.width(), kSliderGrooveWidth);
+                else
+                    groove.setRect(bounds.center().x() - kSliderGrooveWidth / 2, bounds.top(),
+                                   kSliderGrooveWidth, bounds.height());
+
+                drawRoundedPanel(painter, groove, kFrameRadius,
+                                 grayBrush(groove, horizontal ? Qt::Vertical : Qt::Horizontal,
+                                           kSliderGrooveStops, drawsGradients()),
+                                 gray(kButtonBorderGray));
+            }
+
+            if (slider->subControls & SC_SliderTickmarks) {
+                QStyleOptionSlider ticks = *slider;
+                ticks.subControls = SC_SliderTickmarks;
+                QCommonStyle::drawComplexControl(control, &ticks, painter, widget);
+            }
+
+            if (slider->subControls & SC_SliderHandle) {
+                QStyleOptionSlider handle = *slider;
+                handle.rect = subControlRect(control, slider, SC_SliderHandle, widget);
+                drawCached("studio-slider-handle", 0, &handle, painter, widget,
+                           &FrameworkStyle::drawStudioSliderHandle);
+            }
+        }
+        return true;
+
+        case CC_ComboBox:
+        {
+            // Editable combo boxes keep the classic line edit look
+            const QStyleOptionComboBox* combo = qstyleoption_cast<const QStyleOptionComboBox *>(option);
+            if (combo == NULL || combo->editable)
+                return false;
+
+            if (combo->subControls & SC_ComboBoxFrame) {
+                // The body is a button that does not press in
+                QStyleOption body = *combo;
+                body.state &= ~(State_Sunken | State_On);
+                drawCached("studio-button", 0, &body, painter, widget, &FrameworkStyle::drawStudioButton);
+            }
+
+            if (combo->subControls & SC_ComboBoxArrow) {
+                const QRect arrow = subControlRect(control, combo, SC_ComboBoxArrow, widget);
+
+                painter->save();
+                painter->setPen(gray(kButtonBorderGray));
+                painter->drawLine(arrow.topLeft(), arrow.bottomLeft());
+                painter->restore();
+
+                if (!mComboArrowIcon.isNull()) {
+                    drawItemPixmap(painter, arrow, Qt::AlignCenter, mComboArrowIcon);
+                } else {
+                    QStyleOption indicator = *combo;
+                    indicator.rect = arrow.adjusted(kLabelSpacing, kLabelSpacing, -kLabelSpacing, -kLabelSpacing);
+                    drawPrimitive(PE_IndicatorArrowDown, &indicator, painter, widget);
+                }
+            }
+        }
+        return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioButton()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioButton(const QStyleOption* option,
+                                 QPainter* painter,
+                                 const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    const QRect& bounds = option->rect;
+    if (option->state & (State_Sunken | State_On))
+        drawRoundedPanel(painter, bounds, kFrameRadius,
+                         grayBrush(bounds, Qt::Vertical, kButtonPressedStops, drawsGradients()),
+                         gray(kButtonBorderGray));
+    else
+        drawRoundedPanel(painter, bounds, kFrameRadius,
+                         grayBrush(bounds, Qt::Vertical, kButtonStops, drawsGradients()),
+                         gray(kButtonBorderGray));
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioCheckIndicator()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioCheckIndicator(const QStyleOption* option,
+                                         QPainter* painter,
+                                         const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    const QRect& bounds = option->rect;
+    drawRoundedPanel(painter, bounds, kFrameRadius,
+                     grayBrush(bounds, Qt::Vertical, kCheckStops, drawsGradients()),
+                     gray(kButtonBorderGray));
+
+    if (!(option->state & (State_On | State_NoChange)))
+        return;
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(QPen(Qt::black, 2));
+
+    const QRectF mark = QRectF(bounds).adjusted(3, 3, -3, -3);
+    if (option->state & State_NoChange) {
+        painter->drawLine(QPointF(mark.left(), mark.center().y()),
+                          QPointF(mark.right(), mark.center().y()));
+    } else {
+        const QPointF check[] = {
+            QPointF(mark.left(), mark.center().y()),
+            QPointF(mark.left() + mark.width() * 0.4, mark.bottom()),
+            QPointF(mark.right(), mark.top())
+        };
+        painter->drawPolyline(check, 3);
+    }
+
+    painter->restore();
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioHeaderSection()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioHeaderSection(const QStyleOption* option,
+                                        QPainter* painter,
+                                        const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    const QRect& bounds = option->rect;
+    painter->fillRect(bounds, grayBrush(bounds, Qt::Vertical, kHeaderStops, drawsGradients()));
+
+    // Lit on the top and right, shaded on the left and bottom
+    painter->save();
+    painter->setPen(gray(kHeaderLightGray));
+    painter->drawLine(bounds.topLeft(), bounds.topRight());
+    painter->drawLine(bounds.topRight(), bounds.bottomRight());
+    painter->setPen(gray(kFrameBorderGray));
+    painter->drawLine(bounds.topLeft(), bounds.bottomLeft());
+    painter->drawLine(bounds.bottomLeft(), bounds.bottomRight());
+    painter->restore();
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioTabShape()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioTabShape(const QStyleOption* option,
+                                   QPainter* painter,
+                                   const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    const bool selected = option->state & State_Selected;
+    const QRectF bounds = QRectF(option->rect).adjusted(0.5, 0.5, -0.5, -0.5);
+    const qreal diameter = 2 * kTabRadius;
+
+    // Rounded on top, open at the bottom
+    QPainterPath outline;
+    outline.moveTo(bounds.bottomLeft());
+    outline.lineTo(bounds.left(), bounds.top() + kTabRadius);
+    outline.arcTo(QRectF(bounds.left(), bounds.top(), diameter, diameter), 180, -90);
+    outline.lineTo(bounds.right() - kTabRadius, bounds.top());
+    outline.arcTo(QRectF(bounds.right() - diameter, bounds.top(), diameter, diameter), 90, -90);
+    outline.lineTo(bounds.bottomRight());
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(Qt::NoPen);
+    if (selected)
+        painter->setBrush(grayBrush(option->rect, Qt::Vertical, kTabSelectedStops, drawsGradients()));
+    else
+        painter->setBrush(grayBrush(option->rect, Qt::Vertical, kTabStops, drawsGradients()));
+    painter->drawPath(outline);
+
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(gray(selected ? kPaneBorderGray : kTabBorderGray));
+    painter->drawPath(outline);
+
+    // Unselected tabs are shaded on the right, the selected tab opens onto its page
+    if (!selected) {
+        painter->setPen(gray(kPaneBorderGray));
+        painter->drawLine(QPointF(bounds.right(), bounds.top() + kTabRadius), bounds.bottomRight());
+    }
+    painter->setPen(gray(selected ? kWindowGray : kPaneBorderGray));
+    painter->drawLine(bounds.bottomLeft(), bounds.bottomRight());
+
+    painter->restore();
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioScrollBarSlider()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioScrollBarSlider(const QStyleOption* option,
+                                          QPainter* painter,
+                                          const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    const QRect& bounds = option->rect;
+    if (!(option->state & State_Enabled)) {
+        drawRoundedPanel(painter, bounds, kScrollRadius,
+                         gray(kDisabledFillGray), gray(kDisabledBorderGray));
+        return;
+    }
+
+    const Qt::Orientation across = (option->state & State_Horizontal) ? Qt::Vertical : Qt::Horizontal;
+    drawRoundedPanel(painter, bounds, kScrollRadius,
+                     grayBrush(bounds, across, kScrollHandleStops, drawsGradients()),
+                     gray(kScrollBorderGray));
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioScrollBarPage()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioScrollBarPage(const QStyleOption* option,
+                                        QPainter* painter,
+                                        const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    const QRect& bounds = option->rect;
+    if (!(option->state & State_Enabled)) {
+        painter->fillRect(bounds, gray(kDisabledPageGray));
+        return;
+    }
+
+    const Qt::Orientation across = (option->state & State_Horizontal) ? Qt::Vertical : Qt::Horizontal;
+    painter->fillRect(bounds, grayBrush(bounds, across, kScrollPageStops, drawsGradients()));
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioScrollBarAddLine()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioScrollBarAddLine(const QStyleOption* option,
+                                           QPainter* painter,
+                                           const QWidget* widget) const
+{
+    if (option->state & State_Horizontal)
+        drawStudioScrollBarLine(option, painter, widget, mAddLineHorzIcon, PE_IndicatorArrowRight);
+    else
+        drawStudioScrollBarLine(option, painter, widget, mAddLineVertIcon, PE_IndicatorArrowDown);
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioScrollBarSubLine()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioScrollBarSubLine(const QStyleOption* option,
+                                           QPainter* painter,
+                                           const QWidget* widget) const
+{
+    if (option->state & State_Horizontal)
+        drawStudioScrollBarLine(option, painter, widget, mSubLineHorzIcon, PE_IndicatorArrowLeft);
+    else
+        drawStudioScrollBarLine(option, painter, widget, mSubLineVertIcon, PE_IndicatorArrowUp);
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioScrollBarLine()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioScrollBarLine(const QStyleOption* option,
+                                        QPainter* painter,
+                                        const QWidget* widget,
+                                        const QPixmap& arrow,
+                                        PrimitiveElement fallback) const
+{
+    const QRect& bounds = option->rect;
+    const Qt::Orientation across = (option->state & State_Horizontal) ? Qt::Vertical : Qt::Horizontal;
+
+    if (!(option->state & State_Enabled))
+        drawRoundedPanel(painter, bounds, kScrollRadius,
+                         gray(kDisabledFillGray), gray(kDisabledBorderGray));
+    else if (option->state & State_Sunken)
+        drawRoundedPanel(painter, bounds, kScrollRadius,
+                         gray(kScrollPressedGray), gray(kScrollBorderGray));
+    else
+        drawRoundedPanel(painter, bounds, kScrollRadius,
+                         grayBrush(bounds, across, kScrollHandleStops, drawsGradients()),
+                         gray(kScrollBorderGray));
+
+    if (!arrow.isNull()) {
+        drawItemPixmap(painter, bounds, Qt::AlignCenter, arrow);
+    } else {
+        QStyleOption indicator = *option;
+        indicator.rect = bounds.adjusted(3, 3, -3, -3);
+        drawPrimitive(fallback, &indicator, painter, widget);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// FrameworkStyle::drawStudioSliderHandle()
+//-----------------------------------------------------------------------------
+void
+FrameworkStyle::drawStudioSliderHandle(const QStyleOption* option,
+                                       QPainter* painter,
+                                       const QWidget* widget) const
+{
+    Q_UNUSED(widget);
+
+    // A round knob centered in the handle area
+    const QRect& bounds = option->rect;
+    const int side = qMin(kSliderLength, qMin(bounds.width(), bounds.height()));
+    QRect knob(0, 0, side, side);
+    knob.moveCenter(bounds.center());
+
+    drawRoundedPanel(painter, knob, side / 2.0,
+                     grayBrush(knob, Qt::Vertical, kKnobStops, drawsGradients()),
+                     gray(kButtonBorderGray));
+}
+
+
 //-----------------------------------------------------------------------------
 // FrameworkStyle::drawComplexControl()
 //-----------------------------------------------------------------------------
@@ -947,6 +1939,9 @@ FrameworkStyle::drawComplexControl(ComplexControl control,
                                 QPainter* painter, 
                                 const QWidget* widget) const
 {
+    if (mAppearance == AppearanceStudio && drawStudioComplexControl(control, option, painter, widget))
+        return;
+
     QCommonStyle::drawComplexControl(control, option, painter, widget);
 }
 
@@ -1011,6 +2006,50 @@ FrameworkStyle::pixelMetric(PixelMetric metric,
             break;
     }  
 
+    if (mAppearance == AppearanceStudio) {
+        switch (metric) {
+            case PM_ScrollBarExtent:
+            case PM_ScrollBarSliderMin:
+                ret = kScrollBarExtent;
+                break;
+
+            case PM_IndicatorWidth:
+            case PM_IndicatorHeight:
+                ret = kIndicatorSize;
+                break;
+
+            case PM_CheckBoxLabelSpacing:
+            case PM_RadioButtonLabelSpacing:
+                ret = kLabelSpacing;
+                break;
+
+            case PM_SliderLength:
+            case PM_SliderControlThickness:
+                ret = kSliderLength;
+                break;
+
+            case PM_SliderThickness:
+                ret = kSliderThickness;
+                break;
+
+            case PM_DockWidgetSeparatorExtent:
+                ret = kSeparatorExtent;
+                break;
+
+            case PM_DefaultFrameWidth:
+                ret = 1;
+                break;
+
+            case PM_TabBarTabHSpace:
+                // Two pixels of padding and the border on each side
+                ret = kTabHSpace;
+                break;
+
+            default:
+                break;
+        }
+    }
+
     return ret;                              
 }
 
@@ -1049,6 +2088,30 @@ FrameworkStyle::sizeFromContents(ContentsType contentsType,
             break;
     }
 
+    if (mAppearance == AppearanceStudio) {
+        switch (contentsType) {
+            case CT_ComboBox:
+                // The text is padded from the left and followed by the drop down
+                sz = QSize(contentsSize.width() + kComboTextMargin + kComboArrowWidth + 2,
+                           contentsSize.height() + 2);
+                sz = sz.expandedTo(QSize(kComboMinWidth, kComboMinHeight));
+                break;
+
+            case CT_TabBarTab:
+            {
+                const QStyleOptionTab* tab = qstyleoption_cast<const QStyleOptionTab *>(option);
+                if (tab != NULL && tab->shape == QTabBar::RoundedNorth) {
+                    sz.setWidth(qMax(sz.width(), tab->fontMetrics.width(QLatin1Char('x')) * kTabMinWidthEx));
+                    sz.setHeight(kTabHeight);
+                }
+            }
+            break;
+
+            default:
+                break;
+        }
+    }
+
     return sz;
 }
 
@@ -1109,6 +2172,26 @@ FrameworkStyle::subControlRect(ComplexControl control,
                             SubControl subControl, 
                             const QWidget* widget) const
 {
+    if (mAppearance == AppearanceStudio && control == CC_ComboBox) {
+        // The drop down is a fixed column inside the border
+        const QRect bounds = option->rect.adjusted(1, 1, -1, -1);
+
+        switch (subControl) {
+            case SC_ComboBoxArrow:
+                return visualRect(option->direction, option->rect,
+                                  QRect(bounds.right() - kComboArrowWidth + 1, bounds.top(),
+                                        kComboArrowWidth, bounds.height()));
+
+            case SC_ComboBoxEditField:
+                return visualRect(option->direction, option->rect,
+                                  QRect(bounds.left() + kComboTextMargin, bounds.top(),
+                                        bounds.width() - kComboTextMargin - kComboArrowWidth, bounds.height()));
+
+            default:
+                break;
+        }
+    }
+
     return QCommonStyle::subControlRect(control, option, subControl, widget);
 }
 
@@ -23,6 +23,8 @@ THE SOFTWARE.
 
 // Qt
 #include <QCommonStyle>
+#include <QHash>
+#include <QPalette>
 #include <QPixmap>
 
 namespace workspace {
@@ -39,8 +41,14 @@ class FrameworkStyle : public QCommonStyle
     Q_OBJECT
 
 public:
+    /// The look the style draws
+    enum Appearance {
+        AppearanceClassic,  ///< The generated palette and classic bevels
+        AppearanceStudio    ///< The studio theme, drawn without a stylesheet
+    };
+
     /// Default constructor
-    FrameworkStyle();
+    explicit FrameworkStyle(Appearance appearance = AppearanceClassic);
     /// Destructor
     virtual ~FrameworkStyle();
 
@@ -127,11 +135,148 @@ public:
     /// Generate an appropriate palette from the given color and contrast
     QPalette generatePalette(int hue, int sat, int val, int contrast=50) const;
 
+    /// Return the look the style draws
+    Appearance appearance() const;
+    /// Return the palette of the studio theme
+    static QPalette studioPalette();
+
+    /// Switch to the given palette in place, repainting only visible widgets
+    void setThemePalette(const QPalette& palette);
+    /// Switch to a palette generated from the given color and contrast
+    void setThemeColors(int hue, int sat, int val, int contrast=50);
+    /// Return the number of the current theme palette, bumped by every switch
+    quint64 paletteGeneration() const;
+
+    /// Enable or disable gradient fills. The low bandwidth RenderingProfile also disables them.
+    void setGradientsEnabled(bool enabled);
+    /// Return true if gradient fills are enabled for this style
+    bool gradientsEnabled() const;
+
+    /// Enable or disable drawing primitives once and blitting them from the pixmap cache
+    void setPixmapCacheEnabled(bool enabled);
+    /// Return true if primitives are blitted from the pixmap cache
+    bool pixmapCacheEnabled() const;
+
+protected:
+    /// Defer the palette changes of hidden widgets until they are shown
+    virtual bool eventFilter(QObject* watched, QEvent* event);
+
+private Q_SLOTS:
+    /// Forget a deferred palette change when its widget goes away
+    void onDeferredWidgetDestroyed(QObject* widget);
+
 private:
+    /// Install the lighter palettes of the studio item views
+    static void setViewPalettes(const QPalette& palette);
+
+    /// Draws an element at option->rect
+    typedef void (FrameworkStyle::*DrawFunction)(const QStyleOption* option,
+                                                 QPainter* painter,
+                                                 const QWidget* widget) const;
+
+    /// Draw an element with the given function, through the pixmap cache
+    void drawCached(const char* element,
+                    quint64 variant,
+                    const QStyleOption* option,
+                    QPainter* painter,
+                    const QWidget* widget,
+                    DrawFunction draw) const;
+
+    /// Draw the bevel of a push button
+    void drawButtonPanel(const QStyleOption* option,
+                         QPainter* painter,
+                         const QWidget* widget) const;
+    /// Draw the background of a header section
+    void drawHeaderSection(const QStyleOption* option,
+                           QPainter* painter,
+                           const QWidget* widget) const;
+    /// Draw the shape of a tab
+    void drawTabShape(const QStyleOption* option,
+                      QPainter* painter,
+                      const QWidget* widget) const;
+
+    /// Draw a primitive of the studio theme. Return false to fall back on the classic drawing.
+    bool drawStudioPrimitive(PrimitiveElement element,
+                             const QStyleOption* option,
+                             QPainter* painter,
+                             const QWidget* widget) const;
+    /// Draw a control of the studio theme. Return false to fall back on the classic drawing.
+    bool drawStudioControl(ControlElement element,
+                           const QStyleOption* option,
+                           QPainter* painter,
+                           const QWidget* widget) const;
+    /// Draw a complex control of the studio theme. Return false to fall back on the classic drawing.
+    bool drawStudioComplexControl(ComplexControl control,
+                                  const QStyleOptionComplex* option,
+                                  QPainter* painter,
+                                  const QWidget* widget) const;
+
+    /// Draw a studio push or tool button
+    void drawStudioButton(const QStyleOption* option,
+                          QPainter* painter,
+                          const QWidget* widget) const;
+    /// Draw a studio check box indicator
+    void drawStudioCheckIndicator(const QStyleOption* option,
+                                  QPainter* painter,
+                                  const QWidget* widget) const;
+    /// Draw a studio header section
+    void drawStudioHeaderSection(const QStyleOption* option,
+                                 QPainter* painter,
+                                 const QWidget* widget) const;
+    /// Draw a studio tab on a tab bar above its pages
+    void drawStudioTabShape(const QStyleOption* option,
+                            QPainter* painter,
+                            const QWidget* widget) const;
+    /// Draw the handle of a studio scroll bar
+    void drawStudioScrollBarSlider(const QStyleOption* option,
+                                   QPainter* painter,
+                                   const QWidget* widget) const;
+    /// Draw a page area of a studio scroll bar
+    void drawStudioScrollBarPage(const QStyleOption* option,
+                                 QPainter* painter,
+                                 const QWidget* widget) const;
+    /// Draw the button that scrolls a studio scroll bar forward
+    void drawStudioScrollBarAddLine(const QStyleOption* option,
+                                    QPainter* painter,
+                                    const QWidget* widget) const;
+    /// Draw the button that scrolls a studio scroll bar back
+    void drawStudioScrollBarSubLine(const QStyleOption* option,
+                                    QPainter* painter,
+                                    const QWidget* widget) const;
+    /// Draw a scroll bar button with the given arrow, or the fallback primitive without one
+    void drawStudioScrollBarLine(const QStyleOption* option,
+                                 QPainter* painter,
+                                 const QWidget* widget,
+                                 const QPixmap& arrow,
+                                 PrimitiveElement fallback) const;
+    /// Draw the handle of a studio slider
+    void drawStudioSliderHandle(const QStyleOption* option,
+                                QPainter* painter,
+                                const QWidget* widget) const;
+    /// Return true if gradients are drawn now, under the current rendering profile
+    bool drawsGradients() const;
+
+    Appearance mAppearance;
     QPixmap mBranchOpenIcon;
     QPixmap mBranchClosedIcon;  
+    QPixmap mAddLineHorzIcon;
+    QPixmap mAddLineVertIcon;
+    QPixmap mSubLineHorzIcon;
+    QPixmap mSubLineVertIcon;
+    QPixmap mComboArrowIcon;
+    bool mGradientsEnabled;
+    bool mPixmapCacheEnabled;
+    QPalette mThemePalette;
+    quint64 mPaletteGeneration;
+    bool mSwitchingTheme;
+    QHash<QObject*, int> mDeferredChanges;
 };
 
+inline FrameworkStyle::Appearance FrameworkStyle::appearance() const { return mAppearance; }
+inline bool FrameworkStyle::gradientsEnabled() const { return mGradientsEnabled; }
+inline bool FrameworkStyle::pixmapCacheEnabled() const { return mPixmapCacheEnabled; }
+inline quint64 FrameworkStyle::paletteGeneration() const { return mPaletteGeneration; }
+
 } // namespace workspace
 
 
@@ -0,0 +1,139 @@
+#!/usr/bin/env python
+# The MIT License (MIT)
+# Copyright (c) 2011 Gene Z. Ragan
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""Turn a workspace layout file into a statically initialized C++ table.
+
+The layout file is the XML written by WorkspaceArea::saveState(). The
+output is a header defining an EmbeddedLayout, which the application
+hands to Workspace::setDefaultLayout() or WorkspaceArea::restoreState()
+so the default layout costs no file I/O or XML parsing at startup.
+
+Usage: embed_layout.py [--name NAME] INPUT OUTPUT
+
+NAME defaults to k<Input>Layout, e.g. kDefaultWorkspaceLayout for a file
+called defaultWorkspace.
+"""
+
+import argparse
+import os
+import re
+import sys
+import xml.etree.ElementTree as ElementTree
+
+
+def c_string(text):
+    """Return text as a C string literal holding its UTF-8 bytes."""
+    result = '"'
+    for byte in bytearray(text.encode('utf-8')):
+        char = chr(byte)
+        if char in '"\\':
+            result += '\\' + char
+        elif 32 <= byte < 127 and char != '?':
+            result += char
+        else:
+            # Octal escapes can't run into the following character
+            result += '\\%03o' % byte
+    return result + '"'
+
+
+def int_attribute(element, name):
+    return int(element.get(name, '0'))
+
+
+def read_layout(path):
+    root = ElementTree.parse(path).getroot()
+    if root.tag != 'layout':
+        raise ValueError('%s: expected a <layout> element' % path)
+
+    groups = []
+    for group in root.iter('group'):
+        groups.append({
+            'name': group.get('name', ''),
+            'gridx': int_attribute(group, 'gridx'),
+            'gridy': int_attribute(group, 'gridy'),
+            'gridwidth': int_attribute(group, 'gridwidth'),
+            'gridheight': int_attribute(group, 'gridheight'),
+            'x': int_attribute(group, 'x'),
+            'y': int_attribute(group, 'y'),
+            'width': int_attribute(group, 'width'),
+            'height': int_attribute(group, 'height'),
+            'active': int_attribute(group, 'active'),
+            'panels': [panel.get('name', '') for panel in group.iter('panel')],
+        })
+
+    return root.get('name', ''), groups
+
+
+def write_header(out, source, name, layout_name, groups):
+    guard = re.sub(r'^k(?=[A-Z])', '', name)
+    guard = re.sub(r'(?<=[a-z0-9])(?=[A-Z])', '_', guard).upper() + '_HAS_BEEN_INCLUDED'
+
+    out.write('// Generated by embed_layout.py from %s. Do not edit.\n\n' % source)
+    out.write('#ifndef %s\n#define %s\n\n' % (guard, guard))
+    out.write('// Local\n#include "EmbeddedLayout.h"\n\n')
+
+    for index, group in enumerate(groups):
+        if group['panels']:
+            out.write('static const char* const %sPanels%d[] = {\n' % (name, index))
+            for panel in group['panels']:
+                out.write('    %s,\n' % c_string(panel))
+            out.write('};\n\n')
+
+    out.write('static const EmbeddedPanelGroup %sGroups[] = {\n' % name)
+    for index, group in enumerate(groups):
+        panels = '%sPanels%d' % (name, index) if group['panels'] else '0'
+        out.write('    { %s, %d, %d, %d, %d, %d, %d, %d, %d, %d, %s, %d },\n' % (
+            c_string(group['name']),
+            group['gridx'], group['gridy'],
+            group['gridwidth'], group['gridheight'],
+            group['x'], group['y'],
+            group['width'], group['height'],
+            group['active'],
+            panels, len(group['panels'])))
+    if not groups:
+        out.write('    { "", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },\n')
+    out.write('};\n\n')
+
+    out.write('static const EmbeddedLayout %s = {\n' % name)
+    out.write('    %s,\n    %sGroups,\n    %d\n};\n\n' % (c_string(layout_name), name, len(groups)))
+    out.write('#endif // !%s\n' % guard)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Embed a workspace layout file.')
+    parser.add_argument('--name', help='name of the generated EmbeddedLayout')
+    parser.add_argument('input')
+    parser.add_argument('output')
+    args = parser.parse_args()
+
+    name = args.name
+    if not name:
+        base = os.path.splitext(os.path.basename(args.input))[0]
+        name = 'k' + base[:1].upper() + base[1:] + 'Layout'
+
+    layout_name, groups = read_layout(args.input)
+
+    with open(args.output, 'w') as out:
+        write_header(out, os.path.basename(args.input), name, layout_name, groups)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -20,8 +20,37 @@ THE SOFTWARE.
 // Self
 #include "TestWorkspace.h"
 
+// Qt
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDataStream>
+#include <QFile>
+#include <QFutureInterface>
+#include <QGridLayout>
+#include <QLineEdit>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QPushButton>
+#include <QStyleOption>
+#include <QTemporaryDir>
+#include <QTextEdit>
+
 // Local
+#include "../AnimationMonitor.h"
+#include "../DynamicGridLayout.h"
+#include "../FloatingWindowPool.h"
+#include "../LayoutLibrary.h"
+#include "../RenderingProfile.h"
+#include "../UpdateScheduler.h"
+#include "../WidgetAnimator.h"
+#include "../WorkspaceArea.h"
 #include "../WorkspaceItem.h"
+#include "../WorkspaceLayout.h"
+#include "../WorkspacePanel.h"
+#include "../WorkspacePanelDropIndicator.h"
+#include "../WorkspacePanelGroup.h"
+#include "../WorkspaceTabBar.h"
+#include "../theme/FrameworkStyle.h"
 
 class MyWorkspace : public workspace::Workspace
 {
@@ -59,6 +88,91 @@ private:
 };
 
 
+class MyPreparingItem : public workspace::WorkspaceItem
+{
+public:
+    MyPreparingItem(workspace::Workspace* inWorkspace, bool inDefer)
+        :   workspace::WorkspaceItem(inWorkspace),
+            defer(inDefer)
+    {
+    }
+
+    virtual ~MyPreparingItem()
+    {
+        // The work never finishes on its own
+        if (isPreparing())
+            finish(true);
+        cancelPreparation();
+    }
+
+    void finish(bool inCancel)
+    {
+        if (inCancel)
+            work.cancel();
+        work.reportFinished();
+    }
+
+    QList<bool> results;
+
+protected:
+    virtual QFuture<void> prepare()
+    {
+        if (!defer)
+            return workspace::WorkspaceItem::prepare();
+
+        work.reportStarted();
+        return work.future();
+    }
+
+    virtual void prepared(bool inSucceeded)
+    {
+        results << inSucceeded;
+    }
+
+private:
+    bool defer;
+    QFutureInterface<void> work;
+};
+
+
+class MyPanelFactory : public workspace::PanelFactory
+{
+public:
+    virtual QWidget* createPanelWidget(const QString& inName)
+    {
+        names << inName;
+        return new QTextEdit();
+    }
+
+    QStringList names;
+};
+
+
+
+
+QList<WorkspacePanel*>
+TestWorkspace::showPanels(WorkspaceArea& inArea, const QStringList& inNames)
+{
+    WorkspaceLayout* layout = qobject_cast<WorkspaceLayout*>(inArea.layout());
+    Q_ASSERT(layout != NULL);
+
+    // Side by side panels with some content, in an exposed area. The
+    // layout places each in a group of its own, the area would tab them
+    // into the active one.
+    QList<WorkspacePanel*> panels;
+    Q_FOREACH(const QString& name, inNames) {
+        WorkspacePanel* panel = new WorkspacePanel(name, &inArea);
+        panel->setWidget(new QTextEdit(panel));
+        layout->addPanel(panel, Qt::Horizontal);
+        panels << panel;
+    }
+
+    inArea.resize(640, 480);
+    inArea.show();
+    QTest::qWaitForWindowExposed(&inArea);
+
+    return panels;
+}
 
 
 void 
@@ -124,3 +238,768 @@ TestWorkspace::testWorkspaceItem()
     workspace.removeWorkspaceItem(item);
 }
 
+
+void
+TestWorkspace::testLayoutLibraryFormat()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString fileName = directory.filePath("layouts.lib");
+
+    WorkspaceArea::SavedGroup group;
+    group.name = "Group";
+    group.x = group.y = 0;
+    group.width = group.height = 100;
+    group.gridx = group.gridy = 0;
+    group.gridwidth = group.gridheight = 1;
+    group.active = 1;
+    group.panels << "Left" << "Right";
+
+    QMap<QString, SavedLayout> layouts;
+    layouts["First"].layout.second["Panel Group 0"] = group;
+    layouts["First"].geometry = QRect(10, 20, 300, 200);
+    layouts["Second"].layout.second["Panel Group 0"] = group;
+
+    LayoutLibrary library;
+    QVERIFY(library.save(fileName, layouts));
+    QVERIFY(library.isOpen());
+    QCOMPARE(library.getLayoutNames(), QStringList() << "First" << "Second");
+
+    // A reopened library decodes what was saved
+    LayoutLibrary reopened;
+    QVERIFY(reopened.open(fileName));
+
+    SavedLayout layout;
+    QVERIFY(reopened.readLayout("First", layout));
+    QCOMPARE(layout.geometry, QRect(10, 20, 300, 200));
+    QCOMPARE(layout.layout.second.size(), 1);
+    QCOMPARE(layout.layout.second.first().panels, group.panels);
+    QCOMPARE(layout.layout.second.first().active, 1);
+    QVERIFY(!reopened.readLayout("Third", layout));
+}
+
+
+void
+TestWorkspace::testLayoutLibraryCorruptFile_data()
+{
+    QTest::addColumn<quint32>("magic");
+    QTest::addColumn<quint32>("count");
+    QTest::addColumn<quint32>("offset");
+    QTest::addColumn<quint32>("size");
+
+    const quint32 magic = 0x574b4c42;
+
+    QTest::newRow("magic") << quint32(0x12345678) << quint32(1) << quint32(0) << quint32(4);
+    QTest::newRow("count") << magic << quint32(0x10000000) << quint32(0) << quint32(4);
+    QTest::newRow("size") << magic << quint32(1) << quint32(0) << quint32(4096);
+    QTest::newRow("offset") << magic << quint32(1) << quint32(4096) << quint32(0);
+    QTest::newRow("wrap") << magic << quint32(1) << quint32(0xfffffff0) << quint32(0x20);
+}
+
+
+void
+TestWorkspace::testLayoutLibraryCorruptFile()
+{
+    QFETCH(quint32, magic);
+    QFETCH(quint32, count);
+    QFETCH(quint32, offset);
+    QFETCH(quint32, size);
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString fileName = directory.filePath("corrupt.lib");
+
+    // One index entry followed by a few bytes of layout data
+    QByteArray theFile;
+    QDataStream stream(&theFile, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << magic << quint32(1) << count;
+    stream << QString("Layout") << offset << size << QRect();
+    theFile.append("<layout/>");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(theFile), qint64(theFile.size()));
+    file.close();
+
+    LayoutLibrary library;
+    QVERIFY(!library.open(fileName));
+    QVERIFY(!library.isOpen());
+    QVERIFY(library.getLayoutNames().isEmpty());
+}
+
+
+void
+TestWorkspace::testParkedPanels()
+{
+    WorkspaceArea area;
+    WorkspacePanel* left = new WorkspacePanel("Left", &area);
+    WorkspacePanel* right = new WorkspacePanel("Right", &area);
+    area.addPanel(left, Qt::Horizontal);
+    area.addPanel(right, Qt::Horizontal);
+
+    // A layout without the right panel parks it
+    WorkspaceArea::SavedGroup group;
+    group.name = "Group";
+    group.x = group.y = 0;
+    group.width = group.height = 100;
+    group.gridx = group.gridy = 0;
+    group.gridwidth = group.gridheight = 1;
+    group.active = 0;
+    group.panels << "Left";
+
+    WorkspaceArea::SavedLayout layout;
+    layout.second["Panel Group 0"] = group;
+    QVERIFY(area.applyLayout(layout).isEmpty());
+    QVERIFY(right->isHidden());
+
+    // Parked panels are still open
+    QList<WorkspacePanel*> panels;
+    area.getPanelList(panels);
+    QCOMPARE(panels.size(), 2);
+    QVERIFY(panels.contains(right));
+    QCOMPARE(area.findPanel("Right"), right);
+
+    // and drop out when deleted elsewhere
+    delete right;
+    QVERIFY(area.findPanel("Right") == NULL);
+    area.getPanelList(panels);
+    QCOMPARE(panels, QList<WorkspacePanel*>() << left);
+
+    // Closing takes parked panels along
+    WorkspacePanel* parked = new WorkspacePanel("Parked", &area);
+    area.addPanel(parked, Qt::Horizontal);
+    QVERIFY(area.applyLayout(layout).isEmpty());
+    QPointer<WorkspacePanel> guard(parked);
+    area.closePanels();
+    QVERIFY(guard.isNull());
+}
+
+
+void
+TestWorkspace::testExposure()
+{
+    WorkspaceArea area;
+    WorkspacePanel* front = new WorkspacePanel("Front", &area);
+    front->setWidget(new QTextEdit(front));
+    area.addPanel(front, Qt::Horizontal);
+
+    WorkspaceLayout* layout = qobject_cast<WorkspaceLayout*>(area.layout());
+    QVERIFY(layout != NULL);
+    WorkspacePanelGroup* group = layout->findPanelGroup(front);
+    QVERIFY(group != NULL);
+
+    WorkspacePanel* back = new WorkspacePanel("Back", &area);
+    back->setWidget(new QTextEdit(back));
+    group->addTab(back, back->objectName());
+    group->setCurrentWidget(front);
+
+    area.resize(640, 480);
+    area.show();
+    QTest::qWaitForWindowExposed(&area);
+    QCoreApplication::processEvents();
+
+    // Only the current tab is on screen
+    QCOMPARE(front->exposure(), WorkspacePanel::ExposureVisible);
+    QCOMPARE(back->exposure(), WorkspacePanel::ExposureBackground);
+
+    group->setCurrentWidget(back);
+    QCoreApplication::processEvents();
+    QCOMPARE(front->exposure(), WorkspacePanel::ExposureBackground);
+    QCOMPARE(back->exposure(), WorkspacePanel::ExposureVisible);
+
+    // Hiding the window hides everything in it
+    area.hide();
+    QCoreApplication::processEvents();
+    QCOMPARE(front->exposure(), WorkspacePanel::ExposureBackground);
+    QCOMPARE(back->exposure(), WorkspacePanel::ExposureBackground);
+}
+
+
+void
+TestWorkspace::testUpdateScheduler()
+{
+    WorkspaceArea area;
+    WorkspacePanel* front = new WorkspacePanel("Front", &area);
+    front->setWidget(new QTextEdit(front));
+    area.addPanel(front, Qt::Horizontal);
+
+    WorkspaceLayout* layout = qobject_cast<WorkspaceLayout*>(area.layout());
+    QVERIFY(layout != NULL);
+    WorkspacePanelGroup* group = layout->findPanelGroup(front);
+    QVERIFY(group != NULL);
+
+    WorkspacePanel* back = new WorkspacePanel("Back", &area);
+    back->setWidget(new QTextEdit(back));
+    group->addTab(back, back->objectName());
+    group->setCurrentWidget(front);
+
+    area.resize(640, 480);
+    area.show();
+    QTest::qWaitForWindowExposed(&area);
+    area.setActivePanel(front);
+    QCoreApplication::processEvents();
+
+    UpdateScheduler scheduler(&area);
+    scheduler.setFrameInterval(1);
+
+    QAction frontUpdate(NULL);
+    QAction backUpdate(NULL);
+    QSignalSpy frontSpy(&frontUpdate, SIGNAL(triggered(bool)));
+    QSignalSpy backSpy(&backUpdate, SIGNAL(triggered(bool)));
+    scheduler.registerPanel(front, &frontUpdate, SLOT(trigger()));
+    scheduler.registerPanel(back, &backUpdate, SLOT(trigger()));
+
+    QCOMPARE(scheduler.getRate(front), UpdateScheduler::RateFull);
+    QCOMPARE(scheduler.getRate(back), UpdateScheduler::RateNone);
+
+    // Requests are merged, and the background tab is held back
+    scheduler.requestUpdate(front);
+    scheduler.requestUpdate(front);
+    scheduler.requestUpdate(back);
+    QTRY_COMPARE(frontSpy.count(), 1);
+    QTest::qWait(20);
+    QCOMPARE(frontSpy.count(), 1);
+    QCOMPARE(backSpy.count(), 0);
+
+    // until it comes to the front
+    group->setCurrentWidget(back);
+    QTRY_COMPARE(backSpy.count(), 1);
+    QCOMPARE(scheduler.getRate(front), UpdateScheduler::RateNone);
+
+    delete back;
+    QVERIFY(!scheduler.isRegistered(back));
+    QVERIFY(scheduler.isRegistered(front));
+}
+
+
+void
+TestWorkspace::testPluginPanels()
+{
+    MyWorkspace workspace;
+    workspace.initialize();
+
+    MyPanelFactory factory;
+    workspace.registerPanelFactory("Plugin", &factory);
+
+    // Every instance of a class gets a name of its own
+    QCOMPARE(workspace.getUniquePanelName("Plugin"), QString("Plugin"));
+    WorkspacePanel* first = workspace.addPlaceholderPanel("Plugin", NULL);
+    QCOMPARE(workspace.getUniquePanelName("Plugin"), QString("Plugin#2"));
+    WorkspacePanel* second = workspace.addPlaceholderPanel("Plugin#2", NULL);
+    QCOMPARE(workspace.getUniquePanelName("Plugin"), QString("Plugin#3"));
+
+    QCOMPARE(Workspace::getPanelBaseName("Plugin#2"), QString("Plugin"));
+    QCOMPARE(Workspace::getPanelBaseName("Plugin#two"), QString("Plugin#two"));
+    QCOMPARE(Workspace::getPanelBaseName("#2"), QString("#2"));
+
+    // and is built by the factory of its class
+    QVERIFY(workspace.isPlaceholderPanel(first));
+    QVERIFY(workspace.isPlaceholderPanel(second));
+    QVERIFY(workspace.materializePanel(second));
+    QVERIFY(second->widget() != NULL);
+    QVERIFY(first->widget() == NULL);
+    QCOMPARE(factory.names, QStringList() << "Plugin#2");
+
+    workspace.unregisterPanelFactory("Plugin");
+    QVERIFY(!workspace.isPlaceholderPanel(first));
+}
+
+
+void
+TestWorkspace::testPreparation()
+{
+    MyWorkspace workspace;
+    workspace.initialize();
+
+    // Nothing to prepare counts as success, right away
+    MyPreparingItem plain(&workspace, false);
+    plain.startPreparation();
+    QVERIFY(!plain.isPreparing());
+    QCOMPARE(plain.results, QList<bool>() << true);
+
+    // Running work is reported when it finishes
+    MyPreparingItem finished(&workspace, true);
+    finished.startPreparation();
+    QVERIFY(finished.isPreparing());
+    QVERIFY(finished.results.isEmpty());
+    finished.finish(false);
+    QTRY_VERIFY(!finished.isPreparing());
+    QCOMPARE(finished.results, QList<bool>() << true);
+
+    MyPreparingItem canceled(&workspace, true);
+    canceled.startPreparation();
+    canceled.finish(true);
+    QTRY_VERIFY(!canceled.isPreparing());
+    QCOMPARE(canceled.results, QList<bool>() << false);
+
+    // Abandoned work is not reported at all
+    MyPreparingItem abandoned(&workspace, true);
+    abandoned.startPreparation();
+    abandoned.finish(true);
+    abandoned.cancelPreparation();
+    QVERIFY(!abandoned.isPreparing());
+    QTest::qWait(10);
+    QVERIFY(abandoned.results.isEmpty());
+}
+
+
+void
+TestWorkspace::testBusyTab()
+{
+    WorkspaceArea area;
+    WorkspacePanel* panel = showPanels(area, QStringList() << "Panel").first();
+
+    WorkspaceLayout* layout = qobject_cast<WorkspaceLayout*>(area.layout());
+    QVERIFY(layout != NULL);
+    WorkspacePanelGroup* group = layout->findPanelGroup(panel);
+    QVERIFY(group != NULL);
+    WorkspaceTabBar* tabBar = group->getTabBar();
+    const int index = group->indexOf(panel);
+
+    const QTabBar::ButtonPosition closeSide = (QTabBar::ButtonPosition)
+        tabBar->style()->styleHint(QStyle::SH_TabBar_CloseButtonPosition, 0, tabBar);
+    const QTabBar::ButtonPosition otherSide = 
+        closeSide == QTabBar::LeftSide ? QTabBar::RightSide : QTabBar::LeftSide;
+    QWidget* closeButton = tabBar->tabButton(index, closeSide);
+    QVERIFY(closeButton != NULL);
+
+    // Calls nest, and the indicator keeps clear of the close button
+    panel->startProgress();
+    panel->startProgress();
+    QCoreApplication::processEvents();
+    QVERIFY(tabBar->isProgressActive(index));
+    QVERIFY(!tabBar->getProgressRect(index).isEmpty());
+    QVERIFY(!tabBar->getProgressRect(index).intersects(closeButton->geometry()));
+
+    panel->stopProgress();
+    QVERIFY(tabBar->isProgressActive(index));
+    panel->stopProgress();
+    QVERIFY(!tabBar->isProgressActive(index));
+    QVERIFY(tabBar->getProgressRect(index).isEmpty());
+    QCoreApplication::sendPostedEvents(NULL, QEvent::DeferredDelete);
+    QVERIFY(tabBar->tabButton(index, otherSide) == NULL);
+
+    // With both button slots taken it sits beside the buttons
+    QWidget* sideButton = new QWidget(tabBar);
+    sideButton->setFixedSize(16, 16);
+    tabBar->setTabButton(index, otherSide, sideButton);
+
+    panel->startProgress();
+    QCoreApplication::processEvents();
+    const QRect progressRect = tabBar->getProgressRect(index);
+    QVERIFY(!progressRect.isEmpty());
+    QVERIFY(!progressRect.intersects(closeButton->geometry()));
+    QVERIFY(!progressRect.intersects(sideButton->geometry()));
+
+    panel->stopProgress();
+    QCOMPARE(tabBar->tabButton(index, otherSide), sideButton);
+}
+
+
+void 
+TestWorkspace::testDropZoneModel()
+{
+    typedef WorkspacePanelDropIndicator Indicator;
+
+    Indicator::ZoneModel zones(QRect(0, 0, 400, 200));
+    QCOMPARE(zones.getCentralRect(), QRect(50, 50, 300, 100));
+
+    QCOMPARE(zones.classify(QPoint(200, 10)), Indicator::AreaNorth);
+    QCOMPARE(zones.classify(QPoint(200, 190)), Indicator::AreaSouth);
+    QCOMPARE(zones.classify(QPoint(10, 100)), Indicator::AreaWest);
+    QCOMPARE(zones.classify(QPoint(390, 100)), Indicator::AreaEast);
+    QCOMPARE(zones.classify(QPoint(200, 100)), Indicator::AreaCentral);
+
+    zones.setCentralAreaEnabled(false);
+    QCOMPARE(zones.classify(QPoint(200, 100)), Indicator::AreaNone);
+
+    // Every anchor lies in its own zone
+    zones.setCentralAreaEnabled(true);
+    const Indicator::Area areas[] = { Indicator::AreaNorth, Indicator::AreaSouth,
+                                      Indicator::AreaEast, Indicator::AreaWest,
+                                      Indicator::AreaCentral };
+    for (size_t index = 0; index < sizeof(areas) / sizeof(areas[0]); ++index)
+        QCOMPARE(zones.classify(zones.getAnchor(areas[index])), areas[index]);
+
+    QCOMPARE(Indicator::ZoneModel().classify(QPoint(0, 0)), Indicator::AreaNone);
+}
+
+
+void
+TestWorkspace::testAnimationMonitor()
+{
+    AnimationMonitor* monitor = AnimationMonitor::instance();
+    AnimationMonitor::Policy policy;
+    policy.frameBudget = 40;
+    policy.movingLimit = 4;
+
+    // Smooth frames animate fully until too many widgets move
+    for (int frame = 0; frame < 32; ++frame)
+        monitor->reportFrame(16);
+    QCOMPARE(monitor->getLevel(policy, 4), AnimationMonitor::LevelFull);
+    QCOMPARE(monitor->getLevel(policy, 5), AnimationMonitor::LevelReduced);
+    QCOMPARE(monitor->getLevel(policy, 9), AnimationMonitor::LevelOff);
+    QCOMPARE(monitor->getDuration(200, policy, 5), 100);
+
+    // Slow frames turn animations off
+    for (int frame = 0; frame < 32; ++frame)
+        monitor->reportFrame(200);
+    QCOMPARE(monitor->getLevel(policy), AnimationMonitor::LevelOff);
+    QCOMPARE(monitor->getDuration(200, policy), 0);
+
+    // The workspace policy and the global mode override the measurements
+    policy.mode = AnimationMonitor::PerformanceFull;
+    QCOMPARE(monitor->getLevel(policy), AnimationMonitor::LevelFull);
+
+    monitor->setPerformanceMode(AnimationMonitor::PerformanceReduced);
+    QCOMPARE(monitor->getLevel(policy), AnimationMonitor::LevelReduced);
+    monitor->setPerformanceMode(AnimationMonitor::PerformanceAuto);
+
+    // Leave smooth measurements behind for the other tests
+    for (int frame = 0; frame < 64; ++frame)
+        monitor->reportFrame(16);
+}
+
+
+void
+TestWorkspace::testWidgetAnimator()
+{
+    QWidget host;
+    DynamicGridLayout* layout = new DynamicGridLayout();
+    host.setLayout(layout);
+    host.resize(400, 300);
+    host.show();
+    QTest::qWaitForWindowExposed(&host);
+
+    QWidget* widget = new QWidget(&host);
+    widget->setGeometry(0, 0, 100, 100);
+    widget->show();
+
+    // Animate fully, whatever the other tests left measured
+    AnimationMonitor::Policy policy;
+    policy.mode = AnimationMonitor::PerformanceFull;
+    WidgetAnimator animator(layout);
+    animator.setPolicy(policy);
+
+    // A retargeted motion continues from where it is to the new destination
+    const QRect right(200, 0, 100, 100);
+    const QRect down(0, 150, 100, 100);
+    animator.animate(widget, right, true);
+    QTest::qWait(50);
+    QVERIFY(animator.animating(widget));
+    const QRect between = widget->geometry();
+    QVERIFY(between != QRect(0, 0, 100, 100) && between != right);
+
+    animator.animate(widget, down, true);
+    QCOMPARE(widget->geometry(), between);
+    QVERIFY(animator.animating(widget));
+    QTRY_VERIFY(!animator.animating(widget));
+    QCOMPARE(widget->geometry(), down);
+
+    // An aborted motion leaves the widget where it was stopped
+    animator.animate(widget, right, true);
+    QTest::qWait(50);
+    animator.abort(widget);
+    QVERIFY(!animator.animating(widget));
+    const QRect stopped = widget->geometry();
+    QVERIFY(stopped != down && stopped != right);
+    QTest::qWait(250);
+    QCOMPARE(widget->geometry(), stopped);
+
+    // A proxied widget hides in place behind its image until it arrives
+    animator.setMode(WidgetAnimator::ModeProxy);
+    animator.animate(widget, down, true);
+    QVERIFY(widget->isHidden());
+    QCOMPARE(widget->geometry(), stopped);
+    QTRY_VERIFY(!animator.animating(widget));
+    QVERIFY(widget->isVisible());
+    QCOMPARE(widget->geometry(), down);
+
+    // Aborted, it comes back where its image was stopped
+    animator.animate(widget, right, true);
+    QTest::qWait(50);
+    animator.abort(widget);
+    QVERIFY(!animator.animating(widget));
+    QVERIFY(widget->isVisible());
+    QVERIFY(host.rect().contains(widget->geometry()));
+    QVERIFY(widget->geometry() != down && widget->geometry() != right);
+
+    // A layout pass too large to animate moves every widget at once,
+    // not just the ones past the limit
+    policy.mode = AnimationMonitor::PerformanceAuto;
+    policy.frameBudget = 40;
+    policy.movingLimit = 4;
+    animator.setPolicy(policy);
+    for (int frame = 0; frame < 32; ++frame)
+        AnimationMonitor::instance()->reportFrame(16);
+
+    QList<QWidget*> items;
+    for (int index = 0; index < 9; ++index) {
+        QWidget* item = new QWidget(&host);
+        item->setGeometry(0, 0, 10, 10);
+        item->show();
+        items << item;
+    }
+
+    const QRect target(100, 100, 10, 10);
+    animator.beginPass(items.size());
+    Q_FOREACH(QWidget* item, items)
+        animator.animate(item, target, true);
+    animator.endPass();
+
+    Q_FOREACH(QWidget* item, items) {
+        QVERIFY(!animator.animating(item));
+        QCOMPARE(item->geometry(), target);
+    }
+}
+
+
+void
+TestWorkspace::testActivationPixelThroughput()
+{
+    WorkspaceArea area;
+    WorkspacePanel* panel = showPanels(area, QStringList() << "Panel").first();
+
+    RenderingProfile* profile = RenderingProfile::instance();
+    profile->setPixelCounting(true);
+    profile->resetPixelThroughput();
+
+    // Activating a panel repaints its outline, not its content
+    area.setActivePanel(panel);
+    QApplication::processEvents();
+
+    const PixelThroughput& throughput = profile->getPixelThroughput();
+    QVERIFY(throughput.paints > 0);
+    QVERIFY(throughput.pixels < qint64(panel->width()) * panel->height());
+
+    profile->setPixelCounting(false);
+}
+
+
+void
+TestWorkspace::testThemeSwitch()
+{
+    const QPalette savedPalette = QApplication::palette();
+
+    workspace::FrameworkStyle style;
+    const quint64 generation = style.paletteGeneration();
+
+    QWidget shown;
+    shown.show();
+    QTest::qWaitForWindowExposed(&shown);
+    QWidget hidden;
+
+    // The visible window switches at once
+    style.setThemeColors(240, 16, 30);
+    QCOMPARE(style.paletteGeneration(), generation + 1);
+    const QColor night = style.standardPalette().color(QPalette::Window);
+    QCOMPARE(shown.palette().color(QPalette::Window), night);
+
+    // The hidden one when it is shown
+    QVERIFY(hidden.palette().color(QPalette::Window) != night);
+    hidden.show();
+    QCOMPARE(hidden.palette().color(QPalette::Window), night);
+
+    QApplication::setPalette(savedPalette);
+}
+
+
+void
+TestWorkspace::benchmarkUndockRedock_data()
+{
+    QTest::addColumn<int>("capacity");
+
+    QTest::newRow("pooled") << 2;
+    QTest::newRow("unpooled") << 0;
+}
+
+
+void
+TestWorkspace::benchmarkUndockRedock()
+{
+    QFETCH(int, capacity);
+
+    WorkspaceArea area;
+    area.getFloatingWindowPool()->setCapacity(capacity);
+    area.getFloatingWindowPool()->reserve();
+
+    const QList<WorkspacePanel*> panels = showPanels(area, QStringList() << "Panel" << "Anchor");
+    WorkspacePanel* panel = panels.first();
+    WorkspacePanel* anchor = panels.last();
+
+    WorkspaceLayout* layout = qobject_cast<WorkspaceLayout*>(area.layout());
+    QVERIFY(layout != NULL);
+
+    QBENCHMARK {
+        // Undock the way the tab menu does it
+        WorkspacePanelGroup* group = layout->findPanelGroup(panel);
+        QVERIFY(group != NULL);
+        group->onUndockCurrentPanel();
+        QCoreApplication::processEvents();
+        QVERIFY(panel->isFloating());
+
+        // Redock the way a drop onto the other panel does it
+        WorkspacePanelGroup* target = layout->findPanelGroup(anchor);
+        QVERIFY(target != NULL);
+        layout->hover(panel, target->mapToGlobal(target->rect().center()));
+        layout->endHover(panel);
+        QCoreApplication::processEvents();
+        QCoreApplication::sendPostedEvents(NULL, QEvent::DeferredDelete);
+        QVERIFY(!panel->isFloating());
+        QCOMPARE(layout->findPanelGroup(panel), target);
+    }
+}
+
+
+void
+TestWorkspace::benchmarkHoverTargetChange_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("scene") << int(WorkspacePanelDropIndicator::ModeScene);
+    QTest::newRow("overlay") << int(WorkspacePanelDropIndicator::ModeOverlay);
+}
+
+
+void
+TestWorkspace::benchmarkHoverTargetChange()
+{
+    QFETCH(int, mode);
+
+    WorkspaceArea area;
+    WorkspaceLayout* layout = qobject_cast<WorkspaceLayout*>(area.layout());
+    QVERIFY(layout != NULL);
+    layout->getDropIndicator()->setMode(WorkspacePanelDropIndicator::Mode(mode));
+
+    const QList<WorkspacePanel*> panels = showPanels(area, QStringList() << "Left" << "Right");
+
+    WorkspacePanelGroup* leftGroup = layout->findPanelGroup(panels.first());
+    WorkspacePanelGroup* rightGroup = layout->findPanelGroup(panels.last());
+    QVERIFY(leftGroup != NULL && rightGroup != NULL && leftGroup != rightGroup);
+    const QPoint leftPos = leftGroup->mapToGlobal(leftGroup->rect().center());
+    const QPoint rightPos = rightGroup->mapToGlobal(rightGroup->rect().center());
+
+    // Every hover moves the indicator to the other panel
+    QBENCHMARK {
+        layout->hover(NULL, leftPos);
+        QCoreApplication::processEvents();
+        layout->hover(NULL, rightPos);
+        QCoreApplication::processEvents();
+    }
+
+    layout->endHover();
+}
+
+
+void
+TestWorkspace::benchmarkStylePrimitives_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("cached") << true;
+    QTest::newRow("uncached") << false;
+}
+
+
+void
+TestWorkspace::benchmarkStylePrimitives()
+{
+    QFETCH(bool, cached);
+
+    workspace::FrameworkStyle style;
+    style.setPixmapCacheEnabled(cached);
+    QPixmapCache::clear();
+
+    QPixmap target(800, 600);
+    QPainter painter(&target);
+
+    QStyleOptionTab tab;
+    tab.rect = QRect(0, 0, 120, 24);
+    tab.palette = style.standardPalette();
+    tab.state = QStyle::State_Enabled;
+    tab.shape = QTabBar::RoundedNorth;
+    tab.position = QStyleOptionTab::Middle;
+
+    QStyleOptionHeader header;
+    header.rect = QRect(0, 30, 160, 20);
+    header.palette = tab.palette;
+    header.state = QStyle::State_Enabled;
+
+    QStyleOptionButton button;
+    button.rect = QRect(0, 60, 90, 26);
+    button.palette = tab.palette;
+    button.state = QStyle::State_Enabled;
+
+    // 1000 of each, as a large workspace repaints them
+    QBENCHMARK {
+        for (int index = 0; index < 1000; ++index) {
+            style.drawControl(QStyle::CE_TabBarTabShape, &tab, &painter);
+            style.drawControl(QStyle::CE_HeaderSection, &header, &painter);
+            style.drawPrimitive(QStyle::PE_PanelButtonCommand, &button, &painter);
+        }
+    }
+}
+
+
+void
+TestWorkspace::benchmarkStudioTheme_data()
+{
+    QTest::addColumn<bool>("native");
+
+    QTest::newRow("stylesheet") << false;
+    QTest::newRow("native") << true;
+}
+
+
+void
+TestWorkspace::benchmarkStudioTheme()
+{
+    QFETCH(bool, native);
+
+    QString styleSheet;
+    if (!native) {
+        QFile file(QFINDTESTDATA("../theme/resources/studio-theme-normal"));
+        QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+        styleSheet = QString::fromUtf8(file.readAll());
+    }
+
+    workspace::FrameworkStyle style(workspace::FrameworkStyle::AppearanceStudio);
+
+    // Create, polish and paint 2000 widgets, as a large workspace starts up
+    QBENCHMARK {
+        QWidget window;
+        if (native) {
+            window.setStyle(&style);
+            window.setPalette(style.standardPalette());
+        }
+
+        QGridLayout* layout = new QGridLayout(&window);
+        for (int index = 0; index < 2000; ++index) {
+            QWidget* widget = NULL;
+            switch (index % 4) {
+                case 0:
+                    widget = new QPushButton("Button", &window);
+                    break;
+                case 1:
+                    widget = new QCheckBox("Check", &window);
+                    break;
+                case 2:
+                    widget = new QLineEdit("Text", &window);
+                    break;
+                default:
+                    widget = new QComboBox(&window);
+                    break;
+            }
+
+            if (native)
+                widget->setStyle(&style);
+            layout->addWidget(widget, index / 40, index % 40);
+        }
+
+        if (!native)
+            window.setStyleSheet(styleSheet);
+
+        window.grab();
+    }
+}
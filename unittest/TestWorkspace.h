@@ -43,7 +43,31 @@ private Q_SLOTS:
     void testActions();
     void testWindows();
     void testWorkspaceItem();
+    void testLayoutLibraryFormat();
+    void testLayoutLibraryCorruptFile_data();
+    void testLayoutLibraryCorruptFile();
+    void testParkedPanels();
+    void testExposure();
+    void testUpdateScheduler();
+    void testPluginPanels();
+    void testPreparation();
+    void testBusyTab();
+    void testDropZoneModel();
+    void testAnimationMonitor();
+    void testWidgetAnimator();
+    void testActivationPixelThroughput();
+    void testThemeSwitch();
+    void benchmarkUndockRedock_data();
+    void benchmarkUndockRedock();
+    void benchmarkHoverTargetChange_data();
+    void benchmarkHoverTargetChange();
+    void benchmarkStylePrimitives_data();
+    void benchmarkStylePrimitives();
+    void benchmarkStudioTheme_data();
+    void benchmarkStudioTheme();
 
+private:
+    QList<WorkspacePanel*> showPanels(WorkspaceArea& inArea, const QStringList& inNames);
 };
 
 